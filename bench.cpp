@@ -0,0 +1,355 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+/*
+ * Microbenchmarks of the hot paths of the network, at the shapes of the tyre model (14 inputs, 64 neuron hidden
+ * layers, batches of 64 samples). Every benchmark is calibrated so one repetition runs for at least
+ * BENCH_MIN_TIME_MS, then repeated BENCH_REPETITIONS times; the median, fastest and slowest repetitions are
+ * reported per operation, with the heap allocations the matrices made during the repetitions (see arena.h). A
+ * table is printed and the results are written as JSON, so runs of different releases can be compared.
+ *
+ *   F1_STRATEGIES_BENCH [--json <path>] [--filter <substring>] [--max-step-allocations <n>]
+ *
+ * With --max-step-allocations, the run fails when a training step makes more heap allocations than that.
+ * */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "./neural-network/model.h"
+#include "./neural-network/ensemble.h"
+#include "./neural-network/quantized-model.h"
+#include "./data-interpretor/data-loader.h"
+#include "./strategy/strategy.h"
+
+/* BENCH MACROS */
+#define BENCH_MIN_TIME_MS 50
+#define BENCH_REPETITIONS 5
+#define BENCH_INPUTS 14
+#define BENCH_HIDDEN 64
+#define BENCH_OUTPUTS 3
+#define BENCH_BATCH 64
+#define BENCH_ENSEMBLE_MEMBERS 5
+#define BENCH_RACE_LAPS 70
+#define BENCH_SAMPLES 512               // rows of the generated data set, used by the loader and training benchmarks
+#define BENCH_DATA_PATH "bench-data.csv"
+#define BENCH_MODEL_PATH "bench.model"
+
+struct BenchmarkResult {
+    std::string name;
+    size_t iterations = 0;              // per repetition
+    size_t itemsPerOperation = 1;
+    double medianNs = 0.;
+    double minNs = 0.;
+    double maxNs = 0.;
+    double heapAllocations = 0.;        // per operation
+};
+
+/* Utility functions */
+
+/* keeps the compiler from discarding a result that is never read */
+template <typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+BenchmarkResult run(const std::string& name, const size_t& itemsPerOperation, const std::function<void()>& operation) {
+    using Clock = std::chrono::steady_clock;
+    const auto timeOf = [&operation](const size_t& iterations) {
+        const auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i ++) {
+            operation();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+
+    // doubles the iterations until a repetition is long enough to time reliably
+    const double minimumNs = BENCH_MIN_TIME_MS * 1e6;
+    size_t iterations = 1;
+    double elapsed;
+    while ((elapsed = timeOf(iterations)) < minimumNs) {
+        iterations = elapsed > 0 ? std::max(iterations * 2, (size_t)((double)iterations * minimumNs / elapsed)) : iterations * 2;
+    }
+
+    // the calibration doubles as the warm-up, the allocations are only counted on the repetitions
+    const size_t allocations = StepArena::getHeapAllocations();
+    std::vector<double> perOperation(BENCH_REPETITIONS);
+    for (double& ns : perOperation) {
+        ns = timeOf(iterations) / (double)iterations;
+    }
+    const double heapAllocations = (double)(StepArena::getHeapAllocations() - allocations) / (double)(iterations * BENCH_REPETITIONS);
+    std::sort(perOperation.begin(), perOperation.end());
+    return {name, iterations, itemsPerOperation, perOperation[perOperation.size() / 2], perOperation.front(), perOperation.back(), heapAllocations};
+}
+
+Matrix randomColumns(const size_t& rows, const size_t& columns, std::mt19937& generator) {
+    std::uniform_real_distribution<double> distribution(-1., 1.);
+    std::vector<std::vector<double>> values(columns, std::vector<double>(rows));
+    for (std::vector<double>& column : values) {
+        for (double& value : column) value = distribution(generator);
+    }
+    return Matrix::fromColumns(values);
+}
+
+std::unique_ptr<Model> tyreModel() {
+    auto model = std::make_unique<Model>(BENCH_INPUTS, TanH(0.01), std::make_unique<MSE>(0.1));
+    model->addLayer(TanH(0.01), BENCH_HIDDEN);
+    model->addLayer(TanH(0.01), BENCH_HIDDEN);
+    model->addLayer(TanH(0.01), 9);
+    model->addLayer(TanH(0.01), BENCH_OUTPUTS);
+    model->selectOptimiser(std::make_unique<RMSPROP>(0.005));
+    return model;
+}
+
+/* a dry race on three compounds, two sets of each, with decay curves that grow with the tyre's age */
+StrategyEngine raceEngine() {
+    RaceParameters race;
+    race.raceLaps = BENCH_RACE_LAPS;
+    race.pitLossMs = 20000.;
+    race.baseLapTimeMs = 90000.;
+    race.compoundOffsetMs = {0., 400., 800., 0., 0.};
+    race.availableSets = {2, 2, 2, 0, 0};
+    const auto degradation = std::make_shared<PrecomputedDegradation>();
+    for (const Compound& compound : {Compound::SOFT, Compound::MEDIUM, Compound::HARD}) {
+        const double rate = 4. - static_cast<int>(compound);
+        std::vector<SectorDecay> curve;
+        for (int tyreLife = 1; tyreLife <= BENCH_RACE_LAPS; tyreLife ++) {
+            curve.push_back({rate * (6. + 0.3 * tyreLife), rate * 5., rate * (4. + 0.1 * tyreLife)});
+        }
+        degradation->setCurve(compound, curve);
+    }
+    return {race, degradation};
+}
+
+void writeData(const std::string& path, const size_t& columns, std::mt19937& generator) {
+    std::uniform_real_distribution<double> distribution(0., 1.);
+    std::ofstream file(path);
+    for (size_t j = 0; j < columns; j ++) {
+        file << "c" << j << (j + 1 != columns ? "," : "\n");
+    }
+    for (size_t i = 0; i < BENCH_SAMPLES; i ++) {
+        for (size_t j = 0; j < columns; j ++) {
+            file << distribution(generator) << (j + 1 != columns ? "," : "\n");
+        }
+    }
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (const char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+void writeJson(const std::string& path, const std::vector<BenchmarkResult>& results) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file!" << std::endl;
+        return;
+    }
+    char date[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+#if defined(__clang__)
+    const std::string compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    const std::string compiler = "gcc " __VERSION__;
+#else
+    const std::string compiler = "unknown";
+#endif
+#if defined(__AVX2__)
+    const bool avx2 = true;
+#else
+    const bool avx2 = false;
+#endif
+
+    file << std::setprecision(6) << std::fixed;
+    file << "{\n  \"context\": {\n"
+         << "    \"date\": \"" << date << "\",\n"
+         << "    \"compiler\": \"" << jsonEscape(compiler) << "\",\n"
+         << "    \"use_gpu\": " << USE_GPU << ",\n"
+         << "    \"avx2\": " << (avx2 ? "true" : "false") << ",\n"
+         << "    \"min_time_ms\": " << BENCH_MIN_TIME_MS << ",\n"
+         << "    \"repetitions\": " << BENCH_REPETITIONS << "\n"
+         << "  },\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i ++) {
+        const BenchmarkResult& result = results[i];
+        file << "    {\"name\": \"" << jsonEscape(result.name) << "\", \"iterations\": " << result.iterations
+             << ", \"items_per_operation\": " << result.itemsPerOperation
+             << ", \"median_ns\": " << result.medianNs << ", \"min_ns\": " << result.minNs << ", \"max_ns\": " << result.maxNs
+             << ", \"items_per_second\": " << (double)result.itemsPerOperation * 1e9 / result.medianNs
+             << ", \"heap_allocations_per_operation\": " << result.heapAllocations << "}"
+             << (i + 1 != results.size() ? ",\n" : "\n");
+    }
+    file << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string jsonPath = "benchmarks.json", filter;
+    double maxStepAllocations = -1;
+    for (int i = 1; i < argc; i ++) {
+        const std::string argument = argv[i];
+        if (argument == "--json" && i + 1 < argc) jsonPath = argv[++ i];
+        else if (argument == "--filter" && i + 1 < argc) filter = argv[++ i];
+        else if (argument == "--max-step-allocations" && i + 1 < argc) maxStepAllocations = std::stod(argv[++ i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--json <path>] [--filter <substring>] [--max-step-allocations <n>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937 generator(2024);
+    std::vector<BenchmarkResult> results;
+    const auto benchmark = [&](const std::string& name, const size_t& itemsPerOperation, const std::function<void()>& operation) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+        results.push_back(run(name, itemsPerOperation, operation));
+        const BenchmarkResult& result = results.back();
+        std::cout << std::left << std::setw(40) << result.name << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+                  << result.medianNs << " ns/op" << std::setw(14) << (double)result.itemsPerOperation * 1e9 / result.medianNs << " items/s"
+                  << std::setw(10) << std::setprecision(2) << result.heapAllocations << " allocs/op" << std::endl;
+    };
+
+    /* Matrix */
+    const Matrix firstWeights = randomColumns(BENCH_HIDDEN, BENCH_INPUTS, generator);
+    const Matrix hiddenWeights = randomColumns(BENCH_HIDDEN, BENCH_HIDDEN, generator);
+    const Matrix sample = randomColumns(BENCH_INPUTS, 1, generator);
+    const Matrix hiddenSample = randomColumns(BENCH_HIDDEN, 1, generator);
+    const Matrix hiddenBatch = randomColumns(BENCH_HIDDEN, BENCH_BATCH, generator);
+    Matrix accumulator = Matrix::nullMatrix(BENCH_HIDDEN, BENCH_BATCH);
+
+    benchmark("matrix/multiply/64x14*14x1", 1, [&]() { keep(firstWeights * sample); });
+    benchmark("matrix/multiply/64x64*64x1", 1, [&]() { keep(hiddenWeights * hiddenSample); });
+    benchmark("matrix/multiply/64x64*64x64", BENCH_BATCH, [&]() { keep(hiddenWeights * hiddenBatch); });
+    benchmark("matrix/map/64x64", 1, [&]() { keep(Matrix(hiddenBatch.map([](double x) { return x * 0.5; }))); });
+    benchmark("matrix/transpose/64x14", 1, [&]() { keep(firstWeights.transpose()); });
+    benchmark("matrix/transpose/64x64", 1, [&]() { keep(hiddenBatch.transpose()); });
+    benchmark("matrix/add/64x64", 1, [&]() { keep(Matrix(hiddenBatch + hiddenWeights)); });
+    benchmark("matrix/add-assign/64x64", 1, [&]() { accumulator += hiddenBatch; keep(accumulator); });
+
+    /* Activations, a hidden layer's pre-activations for a whole batch */
+    std::vector<std::pair<std::string, std::unique_ptr<ActivationFunction>>> activations;
+    activations.emplace_back("none", std::make_unique<NoActivation>());
+    activations.emplace_back("relu", std::make_unique<ReLU>());
+    activations.emplace_back("leaky-relu", std::make_unique<LeakyReLU>(0.01));
+    activations.emplace_back("elu", std::make_unique<ELU>(1.));
+    activations.emplace_back("elu-approximate", std::make_unique<ELU>(1., true));
+    activations.emplace_back("tanh", std::make_unique<TanH>(0.01));
+    activations.emplace_back("tanh-approximate", std::make_unique<TanH>(0.01, true));
+    activations.emplace_back("sigmoid", std::make_unique<Sigmoid>());
+    activations.emplace_back("sigmoid-approximate", std::make_unique<Sigmoid>(true));
+    for (const auto& [name, activation] : activations) {
+        benchmark("activation/" + name + "/64x64", BENCH_HIDDEN * BENCH_BATCH, [&]() { keep(activation->function(hiddenBatch)); });
+        benchmark("activation/" + name + "/derivative", 1, [&]() { keep(activation->derivative(hiddenBatch(3, 5))); });
+    }
+
+    /* Optimizers, one step on a hidden layer's weights and biases */
+    std::vector<std::pair<std::string, std::unique_ptr<Optimizer>>> optimizers;
+    optimizers.emplace_back("sgd", std::make_unique<NoOptimization>(0.005));
+    optimizers.emplace_back("rmsprop", std::make_unique<RMSPROP>(0.005));
+    optimizers.emplace_back("adam", std::make_unique<ADAM>(0.005));
+    optimizers.emplace_back("adagrad", std::make_unique<ADAGRAD>(0.005));
+    optimizers.emplace_back("adadelta", std::make_unique<ADADelta>(0.005));
+    const Matrix weightGradients = hiddenWeights.map([](double x) { return x * 1e-3; });
+    const Matrix biasGradients = hiddenSample.map([](double x) { return x * 1e-3; });
+    for (const auto& [name, optimizer] : optimizers) {
+        Matrix weights = hiddenWeights.clone(), biases = hiddenSample.clone();
+        benchmark("optimizer/" + name + "/64x64", 1, [&]() {
+            optimizer->updateWeights(weights, weightGradients);
+            optimizer->updateBiases(biases, biasGradients);
+            keep(weights);
+        });
+    }
+
+    /* Data loading */
+    writeData(BENCH_DATA_PATH, BENCH_INPUTS, generator);
+    benchmark("data-loader/load/512x14", BENCH_SAMPLES, [&]() { keep(DataLoader::load(BENCH_DATA_PATH)); });
+    const auto data = DataLoader::load(BENCH_DATA_PATH);
+    benchmark("data-loader/generate-vectors/512x14", BENCH_SAMPLES, [&]() { keep(DataLoader::generateVectors(data)); });
+    std::remove(BENCH_DATA_PATH);
+
+    /* Model */
+    auto model = tyreModel();
+    // the model files are read from and written to the parent directory, see visitor.cpp
+    benchmark("model/export", 1, [&]() { model->save(BENCH_MODEL_PATH); });
+    benchmark("model/import", 1, [&]() { keep(Model::importModel(BENCH_MODEL_PATH)); });
+    for (const std::string prefix : {"weights_", "biases_", "activations_"}) {
+        std::remove(("../" + prefix + BENCH_MODEL_PATH).c_str());
+    }
+
+    const Matrix batch = randomColumns(BENCH_INPUTS, BENCH_BATCH, generator);
+    benchmark("model/predict/single", 1, [&]() { keep(model->predict(sample)); });
+    benchmark("model/predict/batch-64", BENCH_BATCH, [&]() { keep(model->predictBatch(batch)); });
+
+    // the stacked members in one pass against the same members predicting one after the other
+    std::vector<std::unique_ptr<Model>> members;
+    for (size_t m = 0; m < BENCH_ENSEMBLE_MEMBERS; m ++) {
+        members.push_back(tyreModel());
+    }
+    const Ensemble ensemble(members);
+    benchmark("ensemble/predict/5-members-batch-64", BENCH_BATCH, [&]() { keep(ensemble.predict(batch)); });
+    benchmark("ensemble/separate-predicts/5-members-batch-64", BENCH_BATCH, [&]() {
+        for (const std::unique_ptr<Model>& member : members) keep(member->predictBatch(batch));
+    });
+
+    std::vector<Matrix> inputs, targets;
+    for (size_t i = 0; i < BENCH_SAMPLES; i ++) {
+        inputs.push_back(randomColumns(BENCH_INPUTS, 1, generator).map([](double x) { return (x + 1) / 2; }));
+        targets.push_back(randomColumns(BENCH_OUTPUTS, 1, generator).map([](double x) { return (x + 1) / 2; }));
+    }
+    // the int8 copy of the untrained model, one sample at a time and as one batch, against model/predict
+    const QuantizedModel quantizedModel(*model, inputs, QUANTIZATION_CALIBRATION_SAMPLES);
+    benchmark("quantized/predict/single", 1, [&]() { keep(quantizedModel.predict(sample)); });
+    benchmark("quantized/predict/64-singles", BENCH_BATCH, [&]() {
+        for (size_t j = 0; j < BENCH_BATCH; j ++) keep(quantizedModel.predict(inputs[j]));
+    });
+    benchmark("quantized/predict/batch-64", BENCH_BATCH, [&]() { keep(quantizedModel.predictBatch(batch)); });
+
+    // a whole search of the race, then a lap's update, which only reads the kept tables, and an observation, which
+    // also re-solves the stints that run the compound again
+    StrategyEngine engine = raceEngine();
+    benchmark("strategy/plan/70-laps", 1, [&]() { keep(engine.plan(3)); });
+    const LapUpdate update {35, 10, {Compound::SOFT, Compound::MEDIUM}, std::nullopt};
+    const LapUpdate observed {35, 10, {Compound::SOFT, Compound::MEDIUM}, SectorDecay {25., 18., 10.}};
+    keep(engine.replan(update, 3));
+    benchmark("strategy/replan/70-laps", 1, [&]() { keep(engine.replan(update, 3)); });
+    benchmark("strategy/replan/70-laps-observed", 1, [&]() { keep(engine.replan(observed, 3)); });
+
+    // trainNetwork reports its loss every epoch, which would flood the table
+    std::streambuf* output = std::cout.rdbuf();
+    benchmark("model/train-epoch/512-batch-32", BENCH_SAMPLES, [&]() {
+        std::cout.rdbuf(nullptr);
+        model->trainNetwork(inputs, targets, 1, 32);
+        std::cout.rdbuf(output);
+    });
+    // an epoch of a single batch is a single step
+    const std::vector<Matrix> stepInputs(inputs.begin(), inputs.begin() + 32), stepTargets(targets.begin(), targets.begin() + 32);
+    benchmark("model/train-step/batch-32", 32, [&]() {
+        std::cout.rdbuf(nullptr);
+        model->trainNetwork(stepInputs, stepTargets, 1, 32);
+        std::cout.rdbuf(output);
+    });
+
+    writeJson(jsonPath, results);
+    std::cout << results.size() << " benchmarks written to " << jsonPath << std::endl;
+
+    for (const BenchmarkResult& result : results) {
+        if (maxStepAllocations >= 0 && result.name.find("train-step") != std::string::npos && result.heapAllocations > maxStepAllocations) {
+            std::cerr << result.name << " makes " << result.heapAllocations << " heap allocations per step, more than "
+                      << maxStepAllocations << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -1,6 +1,7 @@
 import pandas as pd
 import os
 import fastf1
+import json
 from joblib import dump
 
 
@@ -86,6 +87,8 @@ compound_mapping = {
 df['Team'] = pd.factorize(df['Team'])[0]
 df['Driver'] = pd.factorize(df['Driver'])[0]
 df['Compound'] = df['Compound'].replace(compound_mapping)
+# the session and driver of every lap, unscaled, so cross-validation can keep their laps in one fold
+pd.DataFrame({'Session': pd.factorize(df['Session'])[0], 'Driver': df['Driver']}).to_csv('groups-preprocessed-data.csv', index=False)
 df.drop(columns='Session', inplace=True)
 
 
@@ -103,3 +106,16 @@ dump(XScaler, 'XScaler.joblib')
 dump(YScaler, 'YScaler.joblib')
 
 
+# parameters of the scalers for the C++ side, see data-interpretor/scaler.h
+def save_scaler(scaler, columns, path):
+    with open(path, 'w') as file:
+        json.dump({'columns': list(columns),
+                   'data_min': scaler.data_min_.tolist(),
+                   'data_max': scaler.data_max_.tolist(),
+                   'feature_range': list(scaler.feature_range)}, file)
+
+
+save_scaler(XScaler, X.columns, 'XScaler.json')
+save_scaler(YScaler, Y.columns, 'YScaler.json')
+
+
@@ -0,0 +1,33 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "decay-features.h"
+
+#include <stdexcept>
+
+SectorDecay DecayFeatureEngine::update(const TimingRecord &lap) {
+    if (lap.driver < 0)
+        throw std::invalid_argument("Driver codes can't be negative!");
+    if ((size_t)lap.driver >= this->drivers.size()) this->drivers.resize(lap.driver + 1);
+    DriverState& driver = this->drivers[lap.driver];
+    for (size_t s = 0; s < SECTOR_COUNT; s ++) {
+        PersonalBest& best = driver.personalBests[s];
+        // strictly faster only, the first lap holding the best time stays the baseline like in pandas
+        if (!driver.hasLaps || lap.sectorTimesMs[s] < best.timeMs) best = {lap.sectorTimesMs[s], lap.lapNumber};
+    }
+    driver.hasLaps = true;
+    return this->decayOf(lap);
+}
+
+SectorDecay DecayFeatureEngine::decayOf(const TimingRecord &lap) const {
+    SectorDecay decay {};
+    if (lap.driver < 0 || (size_t)lap.driver >= this->drivers.size() || !this->drivers[lap.driver].hasLaps) return decay;
+    const DriverState& driver = this->drivers[lap.driver];
+    for (size_t s = 0; s < SECTOR_COUNT; s ++) {
+        const PersonalBest& best = driver.personalBests[s];
+        const int lapDifference = lap.lapNumber - best.lapNumber;
+        decay[s] = lapDifference != 0 ? (lap.sectorTimesMs[s] - best.timeMs) / lapDifference : 0.;
+    }
+    return decay;
+}
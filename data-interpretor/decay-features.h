@@ -0,0 +1,47 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_DECAY_FEATURES_H
+#define F1_STRATEGIES_DECAY_FEATURES_H
+
+#include <array>
+#include <vector>
+
+#include "./timing-record.h"
+
+/*
+ * Native, incremental version of calculate_decay_rate in collect_data.py. For every driver and sector it keeps
+ * the personal best time and the lap it was set on (the first one, on a tie), and a lap's decay rate is
+ * (time - personal best) / (lap - personal best lap), 0 on the personal best lap itself. Updating and reading are
+ * O(1). The Python version uses the personal bests of the whole session, so decayOf matches it once the session's
+ * laps have all gone through update, while update returns the rate with the personal bests known so far.
+ * */
+class DecayFeatureEngine {
+public:
+    DecayFeatureEngine() = default;
+    ~DecayFeatureEngine() = default;
+
+    /* takes the lap into the driver's personal bests and returns its decay rates with what is known so far */
+    SectorDecay update(const TimingRecord& lap);
+
+    /* decay rates of a lap against the current personal bests of its driver, without updating them */
+    [[nodiscard]] SectorDecay decayOf(const TimingRecord& lap) const;
+
+    /* collect_data.py computes the personal bests session by session */
+    void startSession() { this->drivers.clear(); }
+
+private:
+    struct PersonalBest {
+        double timeMs;
+        int lapNumber;
+    };
+    struct DriverState {
+        bool hasLaps = false;
+        std::array<PersonalBest, SECTOR_COUNT> personalBests {};
+    };
+
+    std::vector<DriverState> drivers;       // indexed by driver code
+};
+
+#endif //F1_STRATEGIES_DECAY_FEATURES_H
@@ -0,0 +1,310 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "inference-server.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+std::ostream& operator << (std::ostream& o, const InferenceServerStats& stats) {
+    return o << stats.requests << " requests in " << stats.batches << " batches (mean size " << stats.meanBatchSize
+             << "), " << stats.requestsPerSecond << " requests/s, " << stats.invalidRequests << " invalid, latency : " << stats.latency;
+}
+
+InferenceServer::Client::~Client() {
+    ::close(this->fileDescriptor);
+}
+
+InferenceServer::InferenceServer(Model &model, Scaler inputScaler, Scaler outputScaler, const size_t &maxBatch,
+                                 const std::chrono::microseconds &maxWait) :
+        model(model), inputScaler(std::move(inputScaler)), outputScaler(std::move(outputScaler)), maxBatch(maxBatch), maxWait(maxWait) {
+    if (maxBatch == 0)
+        throw std::invalid_argument("Batches must hold at least one request!");
+    if (this->inputScaler.size() != model.getInputLayer()->getNeuronCount() ||
+        model.predictBatch(Matrix::nullMatrix(this->inputScaler.size(), 1)).getRowSize() != this->outputScaler.size())
+        throw std::invalid_argument("The scalers don't match the model's inputs and outputs!");
+}
+
+InferenceServer::~InferenceServer() {
+    this->stop();
+}
+
+void InferenceServer::serve(const std::string &socketPath) {
+    sockaddr_un address {};
+    if (socketPath.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument("Socket path \"" + socketPath + "\" is too long.");
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    const int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0)
+        throw std::runtime_error("Couldn't create a socket: " + std::string(std::strerror(errno)));
+    ::unlink(socketPath.c_str());
+    if (::bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(server, SOMAXCONN) < 0) {
+        const std::string error = std::strerror(errno);
+        ::close(server);
+        throw std::runtime_error("Couldn't listen on \"" + socketPath + "\": " + error);
+    }
+
+    this->serverFileDescriptor = server;
+    {
+        std::lock_guard<std::mutex> lock(this->statsMutex);
+        this->start = std::chrono::steady_clock::now();
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->readersDone = false;
+    }
+    std::thread batcher(&InferenceServer::batchRequests, this);
+    while (!this->stopping) {
+        const int connection = ::accept(server, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR) continue;
+            break;      // stop shuts the server down
+        }
+        const auto client = std::make_shared<Client>(connection);
+        std::lock_guard<std::mutex> lock(this->clientsMutex);
+        this->reapReaders();
+        this->clients.push_back(client);
+        this->readers.emplace_back(&InferenceServer::readClient, this, client);
+    }
+
+    /* the readers see the end of their stream, then the batcher answers everything they queued and leaves */
+    this->stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(this->clientsMutex);
+        for (const std::weak_ptr<Client>& weakClient : this->clients) {
+            if (const std::shared_ptr<Client> client = weakClient.lock()) ::shutdown(client->fileDescriptor, SHUT_RD);
+        }
+    }
+    for (std::thread& reader : this->readers) {
+        reader.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->readersDone = true;
+    }
+    this->queueReady.notify_all();
+    batcher.join();
+    this->readers.clear();
+    this->finishedReaders.clear();
+    this->clients.clear();
+    this->serverFileDescriptor = -1;
+    ::close(server);
+    ::unlink(socketPath.c_str());
+}
+
+void InferenceServer::stop() {
+    // serve takes it from there, the batcher only leaves once the readers are joined
+    this->stopping = true;
+    const int server = this->serverFileDescriptor;
+    if (server >= 0) ::shutdown(server, SHUT_RDWR);
+}
+
+InferenceServerStats InferenceServer::getStats() const {
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    InferenceServerStats stats;
+    stats.requests = this->requests;
+    stats.batches = this->batches;
+    stats.invalidRequests = this->invalidRequests;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->start).count();
+    stats.requestsPerSecond = stats.seconds > 0 ? (double)stats.requests / stats.seconds : 0.;
+    stats.meanBatchSize = stats.batches ? (double)stats.requests / (double)stats.batches : 0.;
+    stats.latency = this->latency.summary();
+    return stats;
+}
+
+void InferenceServer::readClient(const std::shared_ptr<Client> &client) {
+    std::string pending;
+    char chunk[INFERENCE_READ_SIZE];
+    while (true) {
+        const ssize_t size = ::read(client->fileDescriptor, chunk, sizeof(chunk));
+        if (size < 0 && errno == EINTR) continue;
+        if (size <= 0) break;
+        const auto arrival = std::chrono::steady_clock::now();
+        pending.append(chunk, size);
+
+        std::vector<Request> received;
+        size_t start = 0, end;
+        while ((end = pending.find('\n', start)) != std::string::npos) {
+            std::string_view line = std::string_view(pending).substr(start, end - start);
+            start = end + 1;
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (line.empty()) continue;
+
+            Request request {Request::PREDICT, client, {}, {}, arrival};
+            if (line == "STATS") {
+                request.kind = Request::STATS;
+            } else {
+                size_t position = 0;
+                while (position <= line.size()) {
+                    const size_t comma = std::min(line.find(',', position), line.size());
+                    double value;
+                    const auto [pointer, error] = std::from_chars(line.data() + position, line.data() + comma, value);
+                    if (error != std::errc() || pointer != line.data() + comma) {
+                        request.kind = Request::INVALID;
+                        request.error = "not a number: \"" + std::string(line.substr(position, comma - position)) + "\"";
+                        break;
+                    }
+                    request.features.push_back(value);
+                    position = comma + 1;
+                }
+                if (request.kind == Request::PREDICT && request.features.size() != this->inputScaler.size()) {
+                    request.kind = Request::INVALID;
+                    request.error = "expected " + std::to_string(this->inputScaler.size()) + " features, got " + std::to_string(request.features.size());
+                }
+            }
+            received.push_back(std::move(request));
+        }
+        pending.erase(0, start);
+
+        if (received.empty()) continue;
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            for (Request& request : received) {
+                this->queue.push_back(std::move(request));
+            }
+        }
+        this->queueReady.notify_one();
+    }
+    std::lock_guard<std::mutex> lock(this->clientsMutex);
+    this->finishedReaders.push_back(std::this_thread::get_id());
+}
+
+void InferenceServer::reapReaders() {
+    for (const std::thread::id& id : this->finishedReaders) {
+        // a reader is listed once its thread is done with the server, the join only waits for it to exit
+        const auto reader = std::find_if(this->readers.begin(), this->readers.end(), [&id](const std::thread& thread) {
+            return thread.get_id() == id;
+        });
+        if (reader == this->readers.end()) continue;
+        reader->join();
+        this->readers.erase(reader);
+    }
+    this->finishedReaders.clear();
+    // the requests still queued keep their client alive
+    std::erase_if(this->clients, [](const std::weak_ptr<Client>& client) { return client.expired(); });
+}
+
+void InferenceServer::batchRequests() {
+    std::vector<Request> batch;
+    std::vector<std::shared_ptr<Client>> unsent;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->queueMutex);
+            const auto ready = [this]() { return this->readersDone || !this->queue.empty(); };
+            if (unsent.empty()) this->queueReady.wait(lock, ready);
+            else this->queueReady.wait_for(lock, std::chrono::microseconds(INFERENCE_SEND_RETRY_US), ready);
+            if (this->queue.empty() && this->readersDone) break;
+            if (!this->queue.empty()) {
+                // the oldest request waits at most maxWait for the batch to fill up
+                const auto deadline = this->queue.front().arrival + this->maxWait;
+                this->queueReady.wait_until(lock, deadline, [this]() { return this->readersDone || this->queue.size() >= this->maxBatch; });
+                const size_t size = std::min(this->maxBatch, this->queue.size());
+                for (size_t i = 0; i < size; i ++) {
+                    // nobody reads the answers of a disconnected client
+                    if (!this->queue.front().client->disconnected) batch.push_back(std::move(this->queue.front()));
+                    this->queue.pop_front();
+                }
+            }
+        }
+        if (!batch.empty()) this->answer(batch, unsent);
+        batch.clear();
+        InferenceServer::flush(unsent);
+    }
+
+    // nothing can be asked anymore, the clients get a last chance to read their answers
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(INFERENCE_SHUTDOWN_SEND_MS);
+    while (!unsent.empty() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(INFERENCE_SEND_RETRY_US));
+        InferenceServer::flush(unsent);
+    }
+}
+
+void InferenceServer::answer(const std::vector<Request> &batch, std::vector<std::shared_ptr<Client>>& unsent) {
+    std::vector<std::vector<double>> columns;
+    for (const Request& request : batch) {
+        if (request.kind != Request::PREDICT) continue;
+        std::vector<double> scaled(request.features.size());
+        this->inputScaler.transform(request.features.data(), scaled.data());
+        columns.push_back(std::move(scaled));
+    }
+    Matrix predictions;
+    if (!columns.empty()) predictions = this->model.predictBatch(Matrix::fromColumns(columns));
+
+    size_t column = 0, predicted = 0, invalid = 0;
+    std::vector<double> outputs(predictions.getRowSize());
+    for (const Request& request : batch) {
+        std::ostringstream line;
+        switch (request.kind) {
+            case Request::PREDICT:
+                // enough digits for the client to read back the exact doubles
+                line.precision(std::numeric_limits<double>::max_digits10);
+                for (size_t i = 0; i < outputs.size(); i ++) {
+                    outputs[i] = predictions(i, column);
+                }
+                this->outputScaler.inverseTransform(outputs.data(), outputs.data());
+                for (size_t i = 0; i < outputs.size(); i ++) {
+                    line << outputs[i] << (i + 1 != outputs.size() ? "," : "");
+                }
+                column ++;
+                predicted ++;
+                break;
+            case Request::STATS:
+                line << this->getStats();
+                break;
+            case Request::INVALID:
+                line << "ERROR " << request.error;
+                invalid ++;
+                break;
+        }
+        line << "\n";
+        InferenceServer::reply(request.client, line.str(), unsent);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    this->requests += predicted;
+    this->invalidRequests += invalid;
+    if (predicted) this->batches ++;
+    for (const Request& request : batch) {
+        if (request.kind == Request::PREDICT) this->latency.record(now - request.arrival);
+    }
+}
+
+void InferenceServer::reply(const std::shared_ptr<Client> &client, const std::string &line, std::vector<std::shared_ptr<Client>>& unsent) {
+    if (client->disconnected) return;
+    if (client->unsent.empty()) unsent.push_back(client);
+    client->unsent += line;
+}
+
+void InferenceServer::flush(std::vector<std::shared_ptr<Client>> &unsent) {
+    std::erase_if(unsent, [](const std::shared_ptr<Client>& client) {
+        while (!client->unsent.empty()) {
+            // a client that left doesn't take the daemon down with a SIGPIPE
+            const ssize_t size = ::send(client->fileDescriptor, client->unsent.data(), client->unsent.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (size < 0 && errno == EINTR) continue;
+            if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (client->unsent.size() <= INFERENCE_MAX_UNSENT_BYTES) return false;
+                // a client that doesn't read its answers is let go rather than buffered without end, its reader sees
+                // the end of the stream
+                ::shutdown(client->fileDescriptor, SHUT_RDWR);
+            }
+            if (size <= 0) {
+                client->unsent.clear();
+                client->disconnected = true;
+                return true;
+            }
+            client->unsent.erase(0, size);
+        }
+        return true;
+    });
+}
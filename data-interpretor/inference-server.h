@@ -0,0 +1,120 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_INFERENCE_SERVER_H
+#define F1_STRATEGIES_INFERENCE_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./latency.h"
+#include "./scaler.h"
+#include "../neural-network/model.h"
+
+/* INFERENCE SERVER MACROS */
+#define INFERENCE_MAX_BATCH 64
+#define INFERENCE_MAX_WAIT_US 500               // longest a request waits for its batch to fill up
+#define INFERENCE_LATENCY_WINDOW 100000         // latest requests the latency percentiles are computed on
+#define INFERENCE_READ_SIZE 4096
+#define INFERENCE_MAX_UNSENT_BYTES (1 << 20)   // answers a client may leave unread before it is disconnected
+#define INFERENCE_SEND_RETRY_US 1000            // how often answers a socket didn't take are offered again
+#define INFERENCE_SHUTDOWN_SEND_MS 1000         // how long the last answers are offered once serve returns
+
+struct InferenceServerStats {
+    size_t requests = 0;
+    size_t batches = 0;
+    size_t invalidRequests = 0;
+    double seconds = 0.;
+    double requestsPerSecond = 0.;
+    double meanBatchSize = 0.;
+    LatencySummary latency;                     // from the read of a request to the write of its answer
+
+    friend std::ostream& operator << (std::ostream& o, const InferenceServerStats& stats);
+};
+
+/*
+ * Inference daemon on a Unix domain socket. Clients send one request per line, the comma separated raw features
+ * of a sample (or STATS), and get one line back per request, in order: the unscaled predictions, the statistics,
+ * or "ERROR <reason>". Every client has a reader thread queueing its requests, a single batching thread takes
+ * up to maxBatch of them (waiting at most maxWait after the oldest one) and runs them through the model in one
+ * batched forward pass, so the model is only ever used by that thread. The batching thread never blocks on a
+ * client: the answers of a batch are appended to each client's output and sent with non-blocking writes, what a
+ * socket doesn't take is offered again every INFERENCE_SEND_RETRY_US, and a client that leaves more than
+ * INFERENCE_MAX_UNSENT_BYTES unread is disconnected. On stop, the readers are joined before the batching thread,
+ * so every request read gets its answer.
+ * */
+class InferenceServer {
+public:
+    InferenceServer(Model& model, Scaler inputScaler, Scaler outputScaler, const size_t& maxBatch, const std::chrono::microseconds& maxWait);
+    ~InferenceServer();
+
+    /* blocks until stop is called */
+    void serve(const std::string& socketPath);
+    /* may be called from any thread */
+    void stop();
+
+    [[nodiscard]] InferenceServerStats getStats() const;
+
+private:
+    struct Client {
+        explicit Client(const int& fileDescriptor) : fileDescriptor(fileDescriptor) {}
+        ~Client();
+        int fileDescriptor;
+        // only touched by the batching thread
+        std::string unsent;
+        bool disconnected = false;
+    };
+
+    struct Request {
+        enum Kind { PREDICT, STATS, INVALID } kind;
+        std::shared_ptr<Client> client;
+        std::vector<double> features;
+        std::string error;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    void readClient(const std::shared_ptr<Client>& client);
+    /* joins the readers whose client left and forgets the clients nothing holds anymore, clientsMutex held */
+    void reapReaders();
+    void batchRequests();
+    void answer(const std::vector<Request>& batch, std::vector<std::shared_ptr<Client>>& unsent);
+    /* queues the line in the client's output, the client joins unsent if it wasn't there */
+    static void reply(const std::shared_ptr<Client>& client, const std::string& line, std::vector<std::shared_ptr<Client>>& unsent);
+    /* sends what the sockets take without blocking and keeps the clients that still have answers to send */
+    static void flush(std::vector<std::shared_ptr<Client>>& unsent);
+
+    Model& model;
+    Scaler inputScaler;
+    Scaler outputScaler;
+    size_t maxBatch;
+    std::chrono::microseconds maxWait;
+
+    std::atomic<bool> stopping {false};
+    std::atomic<int> serverFileDescriptor {-1};
+    std::mutex clientsMutex;
+    std::vector<std::weak_ptr<Client>> clients;
+    std::vector<std::thread> readers;
+    std::vector<std::thread::id> finishedReaders;  // readers that returned, joined on the next accept
+
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<Request> queue;
+    bool readersDone = false;                       // no request can be queued anymore, the batcher may leave
+
+    mutable std::mutex statsMutex;
+    std::chrono::steady_clock::time_point start;
+    size_t requests = 0;
+    size_t batches = 0;
+    size_t invalidRequests = 0;
+    LatencyRecorder latency {INFERENCE_LATENCY_WINDOW};
+};
+
+#endif //F1_STRATEGIES_INFERENCE_SERVER_H
@@ -0,0 +1,71 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_LATENCY_H
+#define F1_STRATEGIES_LATENCY_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ostream>
+#include <vector>
+
+struct LatencySummary {
+    size_t count = 0;
+    double meanUs = 0.;
+    double p50Us = 0.;
+    double p90Us = 0.;
+    double p99Us = 0.;
+    double maxUs = 0.;
+
+    friend std::ostream& operator << (std::ostream& o, const LatencySummary& summary) {
+        return o << summary.count << " samples, mean " << summary.meanUs << " us, p50 " << summary.p50Us
+                 << " us, p90 " << summary.p90Us << " us, p99 " << summary.p99Us << " us, max " << summary.maxUs << " us";
+    }
+};
+
+/*
+ * Keeps the samples of one thread, summarised on demand with nearest-rank percentiles. With a window, only the
+ * last window samples are kept, which bounds the memory of a long-running process.
+ * */
+class LatencyRecorder {
+public:
+    explicit LatencyRecorder(const size_t& window = 0) : window(window) {}
+    ~LatencyRecorder() = default;
+
+    void record(const std::chrono::steady_clock::duration& latency) {
+        const double sample = std::chrono::duration<double, std::micro>(latency).count();
+        if (this->window == 0 || this->samplesUs.size() < this->window) this->samplesUs.push_back(sample);
+        else this->samplesUs[this->next ++ % this->window] = sample;
+    }
+
+    [[nodiscard]] LatencySummary summary() const {
+        LatencySummary summary;
+        summary.count = this->samplesUs.size();
+        if (this->samplesUs.empty()) return summary;
+        std::vector<double> sorted = this->samplesUs;
+        std::sort(sorted.begin(), sorted.end());
+        const auto percentile = [&sorted](const double& p) {
+            const size_t rank = (size_t)std::ceil(p / 100. * (double)sorted.size());
+            return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+        };
+        double sum = 0.;
+        for (const double& sample : sorted) {
+            sum += sample;
+        }
+        summary.meanUs = sum / (double)sorted.size();
+        summary.p50Us = percentile(50);
+        summary.p90Us = percentile(90);
+        summary.p99Us = percentile(99);
+        summary.maxUs = sorted.back();
+        return summary;
+    }
+
+private:
+    size_t window;
+    size_t next = 0;
+    std::vector<double> samplesUs;
+};
+
+#endif //F1_STRATEGIES_LATENCY_H
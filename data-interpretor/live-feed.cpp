@@ -0,0 +1,198 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "live-feed.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+int LiveFeed::listen(const std::string &socketPath) {
+    sockaddr_un address {};
+    if (socketPath.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument("Socket path \"" + socketPath + "\" is too long.");
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    const int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0)
+        throw std::runtime_error("Couldn't create a socket: " + std::string(std::strerror(errno)));
+    ::unlink(socketPath.c_str());
+    if (::bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(server, 1) < 0) {
+        const std::string error = std::strerror(errno);
+        ::close(server);
+        throw std::runtime_error("Couldn't listen on \"" + socketPath + "\": " + error);
+    }
+    const int connection = ::accept(server, nullptr, nullptr);
+    const std::string error = std::strerror(errno);
+    ::close(server);
+    ::unlink(socketPath.c_str());
+    if (connection < 0)
+        throw std::runtime_error("Couldn't accept a connection on \"" + socketPath + "\": " + error);
+    return connection;
+}
+
+int LiveFeed::openPipe(const std::string &path) {
+    if (path == "-") return ::dup(STDIN_FILENO);
+    const int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+        throw std::runtime_error("Couldn't open \"" + path + "\": " + std::string(std::strerror(errno)));
+    return fileDescriptor;
+}
+
+LiveFeed::LiveFeed(Model &model, Scaler inputScaler, Scaler outputScaler, LapCallback onLap) :
+        model(model), inputScaler(std::move(inputScaler)), outputScaler(std::move(outputScaler)), onLap(std::move(onLap)),
+        buffer(std::make_unique<SpscRingBuffer<TimingRecord, LIVE_FEED_CAPACITY>>()) {
+    if (this->inputScaler.size() != FEATURE_COUNT || this->outputScaler.size() != SECTOR_COUNT)
+        throw std::invalid_argument("The scalers must match the model's inputs and outputs!");
+}
+
+LiveFeed::~LiveFeed() {
+    this->stop();
+}
+
+void LiveFeed::start(const int &fileDescriptor) {
+    if (this->reader.joinable())
+        throw std::runtime_error("The live feed is already running!");
+    this->fileDescriptor = fileDescriptor;
+    this->sourceClosed = false;
+    this->stopping = false;
+    this->reader = std::thread(&LiveFeed::produce, this);
+    this->inference = std::thread(&LiveFeed::consume, this);
+}
+
+void LiveFeed::wait() {
+    if (this->reader.joinable()) this->reader.join();
+    if (this->inference.joinable()) this->inference.join();
+}
+
+void LiveFeed::stop() {
+    this->stopping = true;
+    this->signal();
+    this->wait();
+}
+
+LiveFeedStats LiveFeed::getStats() const {
+    LiveFeedStats stats;
+    stats.lines = this->lines;
+    stats.skippedLines = this->skippedLines;
+    stats.laps = this->laps;
+    stats.bufferFullWaits = this->bufferFullWaits;
+    stats.latency = this->latency.summary();
+    return stats;
+}
+
+void LiveFeed::produce() {
+    std::string pending;
+    char chunk[LIVE_FEED_READ_SIZE];
+    const auto pushLine = [this](const std::string_view& line, const std::chrono::steady_clock::time_point& arrival) {
+        if (line.empty()) return;
+        this->lines ++;
+        std::optional<TimingRecord> record = this->parser.parse(line);
+        if (!record) {
+            this->skippedLines ++;
+            return;
+        }
+        record->arrival = arrival;
+        size_t spins = 0;
+        while (true) {
+            // read before trying, a pop in between changes it and the sleep returns at once
+            const uint32_t seen = this->events.load(std::memory_order_acquire);
+            if (this->buffer->tryPush(*record)) break;
+            if (this->stopping) return;
+            if (spins == 0) this->bufferFullWaits ++;
+            this->idle(spins, seen);
+        }
+        this->signal();
+    };
+
+    pollfd source {this->fileDescriptor, POLLIN, 0};
+    while (!this->stopping) {
+        const int ready = ::poll(&source, 1, LIVE_FEED_POLL_TIMEOUT_MS);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready == 0) continue;
+        const ssize_t size = ready < 0 ? -1 : ::read(this->fileDescriptor, chunk, sizeof(chunk));
+        if (size < 0 && errno == EINTR) continue;
+        const auto arrival = std::chrono::steady_clock::now();
+        if (size <= 0) {
+            // end of the stream (or a broken one), whatever is left is the last line
+            pushLine(pending, arrival);
+            break;
+        }
+        pending.append(chunk, size);
+        size_t start = 0, end;
+        while ((end = pending.find('\n', start)) != std::string::npos) {
+            pushLine(std::string_view(pending).substr(start, end - start), arrival);
+            start = end + 1;
+        }
+        pending.erase(0, start);
+    }
+    ::close(this->fileDescriptor);
+    this->fileDescriptor = -1;
+    this->sourceClosed.store(true, std::memory_order_release);
+    this->signal();
+}
+
+void LiveFeed::consume() {
+    TimingRecord lap;
+    size_t spins = 0;
+    while (!this->stopping) {
+        const uint32_t seen = this->events.load(std::memory_order_acquire);
+        if (this->buffer->tryPop(lap)) {
+            this->signal();
+            this->infer(lap);
+            spins = 0;
+        } else if (this->sourceClosed.load(std::memory_order_acquire)) {
+            // the reader pushes everything before closing, one more look catches its last laps
+            if (this->buffer->empty()) break;
+        } else {
+            this->idle(spins, seen);
+        }
+    }
+}
+
+void LiveFeed::signal() {
+    this->events.fetch_add(1, std::memory_order_release);
+    this->events.notify_all();
+}
+
+void LiveFeed::idle(size_t &spins, const uint32_t &seen) {
+    if (spins < LIVE_FEED_SPIN_LIMIT) {
+        spins ++;
+        std::this_thread::yield();
+    } else {
+        this->events.wait(seen, std::memory_order_acquire);
+    }
+}
+
+void LiveFeed::infer(TimingRecord &lap) {
+    if (lap.session != this->session) {
+        this->decayFeatures.startSession();
+        this->session = lap.session;
+    }
+    const SectorDecay observedDecay = this->decayFeatures.update(lap);
+    if (!lap.decayRatesMs) lap.decayRatesMs = observedDecay;
+    // scaled in place on the stack, then written once into the rows the model reads
+    std::array<double, FEATURE_COUNT> features = lap.features();
+    this->inputScaler.transform(features.data(), features.data());
+    Matrix::Rows input = Matrix::allocateRows(FEATURE_COUNT, 1);
+    for (size_t k = 0; k < FEATURE_COUNT; k ++) {
+        input[k][0] = features[k];
+    }
+    const Matrix prediction = this->model.predict(Matrix(std::move(input)));
+    SectorDecay decay;
+    for (size_t s = 0; s < SECTOR_COUNT; s ++) {
+        decay[s] = prediction(s, 0);
+    }
+    this->outputScaler.inverseTransform(decay.data(), decay.data());
+    if (this->onLap) this->onLap(lap, decay);
+    this->laps ++;
+    this->latency.record(std::chrono::steady_clock::now() - lap.arrival);
+}
@@ -0,0 +1,101 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_LIVE_FEED_H
+#define F1_STRATEGIES_LIVE_FEED_H
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "./decay-features.h"
+#include "./latency.h"
+#include "./ring-buffer.h"
+#include "./scaler.h"
+#include "./timing-record.h"
+#include "../neural-network/model.h"
+
+/* LIVE FEED MACROS */
+#define LIVE_FEED_CAPACITY 1024             // laps buffered between the reader and the inference thread
+#define LIVE_FEED_READ_SIZE 4096
+#define LIVE_FEED_POLL_TIMEOUT_MS 100       // how often a blocked reader checks whether it was stopped
+#define LIVE_FEED_SPIN_LIMIT 64             // tries a thread yields through before it sleeps until the other one moves
+
+struct LiveFeedStats {
+    size_t lines = 0;
+    size_t skippedLines = 0;                // headers and malformed lines
+    size_t laps = 0;                        // laps that went through inference
+    size_t bufferFullWaits = 0;             // laps the reader had to wait for the inference thread to make room for
+    LatencySummary latency;                 // from the read of a lap's line to the end of its strategy update
+};
+
+/*
+ * Live timing ingestion. A reader thread parses the lines coming from a pipe or a local socket (one completed
+ * lap per line, see TimingParser) into a single-producer / single-consumer ring buffer, an inference thread pops
+ * the laps, scales them in place and writes them once into the model's input column, predicts their sector decay and hands both to the strategy callback.
+ * Laps that don't come with their observed decay rates get them from a DecayFeatureEngine fed with the whole feed,
+ * restarted whenever the Session column changes.
+ * A thread that finds the buffer full (reader) or empty (inference) yields a few times, then sleeps on an atomic
+ * counter the other thread bumps on every push, pop, close and stop, so an idle feed costs no CPU.
+ * Only the inference thread touches the model, which must not be trained while the feed runs.
+ * */
+class LiveFeed {
+public:
+    using LapCallback = std::function<void(const TimingRecord& lap, const SectorDecay& decay)>;
+
+    /* waits for one connection on a Unix domain socket, returns its file descriptor */
+    static int listen(const std::string& socketPath);
+    /* opens a FIFO (or any file) for reading, "-" for the standard input */
+    static int openPipe(const std::string& path);
+
+    LiveFeed(Model& model, Scaler inputScaler, Scaler outputScaler, LapCallback onLap);
+    ~LiveFeed();
+
+    /* takes ownership of the file descriptor, closed once the feed is done with it */
+    void start(const int& fileDescriptor);
+    /* until the source is closed and every lap read went through inference */
+    void wait();
+    /* without waiting for the laps still buffered */
+    void stop();
+
+    /* only consistent once wait or stop returned */
+    [[nodiscard]] LiveFeedStats getStats() const;
+
+private:
+    void produce();
+    void consume();
+    void infer(TimingRecord& lap);
+    /* wakes the other thread */
+    void signal();
+    /* a failed try, yields for the first ones then sleeps until a signal after seen */
+    void idle(size_t& spins, const uint32_t& seen);
+
+    Model& model;
+    Scaler inputScaler;
+    Scaler outputScaler;
+    LapCallback onLap;
+
+    std::unique_ptr<SpscRingBuffer<TimingRecord, LIVE_FEED_CAPACITY>> buffer;
+    TimingParser parser;
+    DecayFeatureEngine decayFeatures;       // only used by the inference thread
+    int session = -1;                       // of the last lap through decayFeatures
+    int fileDescriptor = -1;
+    std::thread reader;
+    std::thread inference;
+    std::atomic<bool> sourceClosed {false};
+    std::atomic<bool> stopping {false};
+    std::atomic<uint32_t> events {0};       // bumped by signal, what an idle thread sleeps on
+
+    // each counter is written by a single thread
+    size_t lines = 0;
+    size_t skippedLines = 0;
+    size_t bufferFullWaits = 0;
+    size_t laps = 0;
+    LatencyRecorder latency;
+};
+
+#endif //F1_STRATEGIES_LIVE_FEED_H
@@ -0,0 +1,60 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_RING_BUFFER_H
+#define F1_STRATEGIES_RING_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/* RING BUFFER MACROS */
+#define CACHE_LINE_SIZE 64
+
+/*
+ * Fixed-size, lock-free queue for exactly one producer thread and one consumer thread. Each index is only
+ * written by its owner (tail by the producer, head by the consumer) and published with release / acquire,
+ * so a slot is never read before it is fully written. The indices live on separate cache lines so the two
+ * threads don't invalidate each other's line on every operation.
+ * */
+template <typename T, size_t Capacity>
+class SpscRingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two.");
+
+public:
+    SpscRingBuffer() = default;
+    ~SpscRingBuffer() = default;
+    SpscRingBuffer(const SpscRingBuffer& other) = delete;
+    SpscRingBuffer& operator = (const SpscRingBuffer& other) = delete;
+
+    /* producer side, false when the buffer is full */
+    bool tryPush(T value) {
+        const size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - this->head.load(std::memory_order_acquire) == Capacity) return false;
+        this->slots[tail & (Capacity - 1)] = std::move(value);
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* consumer side, false when the buffer is empty */
+    bool tryPop(T& value) {
+        const size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == this->tail.load(std::memory_order_acquire)) return false;
+        value = std::move(this->slots[head & (Capacity - 1)]);
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] bool empty() const { return this->head.load(std::memory_order_acquire) == this->tail.load(std::memory_order_acquire); }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head {0};     // next slot to read, owned by the consumer
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail {0};     // next slot to write, owned by the producer
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> slots {};
+};
+
+#endif //F1_STRATEGIES_RING_BUFFER_H
@@ -0,0 +1,160 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "scaler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "../neural-network/model.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/* Utility functions */
+/* the raw text of the JSON array held by key, without its brackets */
+std::string jsonArray(const std::string& json, const std::string& key, const std::string& path) {
+    const size_t keyPosition = json.find("\"" + key + "\"");
+    const size_t start = keyPosition == std::string::npos ? std::string::npos : json.find('[', keyPosition);
+    const size_t end = start == std::string::npos ? std::string::npos : json.find(']', start);
+    if (end == std::string::npos)
+        throw std::invalid_argument("\"" + path + "\" has no \"" + key + "\" array.");
+    return json.substr(start + 1, end - start - 1);
+}
+
+std::vector<double> jsonNumbers(const std::string& array) {
+    std::vector<double> numbers;
+    std::istringstream iss(array);
+    std::string value;
+    while (std::getline(iss, value, ',')) {
+        if (value.find_first_not_of(" \t\r\n") == std::string::npos) continue;
+        numbers.push_back(std::stod(value));
+    }
+    return numbers;
+}
+
+std::vector<std::string> jsonStrings(const std::string& array) {
+    std::vector<std::string> strings;
+    size_t start = array.find('"');
+    while (start != std::string::npos) {
+        const size_t end = array.find('"', start + 1);
+        if (end == std::string::npos) break;
+        strings.push_back(array.substr(start + 1, end - start - 1));
+        start = array.find('"', end + 1);
+    }
+    return strings;
+}
+
+Scaler Scaler::load(const std::string &path) {
+    std::ifstream file(path);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open file \"" + path + "\"");
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string json = buffer.str();
+
+    std::vector<std::string> columns;
+    if (json.find("\"columns\"") != std::string::npos) columns = jsonStrings(jsonArray(json, "columns", path));
+    double lower = 0., upper = 1.;
+    if (json.find("\"feature_range\"") != std::string::npos) {
+        const std::vector<double> range = jsonNumbers(jsonArray(json, "feature_range", path));
+        if (range.size() != 2)
+            throw std::invalid_argument("\"" + path + "\" has an invalid feature range.");
+        lower = range[0];
+        upper = range[1];
+    }
+    return {jsonNumbers(jsonArray(json, "data_min", path)), jsonNumbers(jsonArray(json, "data_max", path)), columns, lower, upper};
+}
+
+Scaler::Scaler(std::vector<double> dataMin, std::vector<double> dataMax, std::vector<std::string> columns,
+               const double &lower, const double &upper) :
+        dataMin(std::move(dataMin)), dataMax(std::move(dataMax)), columns(std::move(columns)), lower(lower), upper(upper) {
+    if (this->dataMin.size() != this->dataMax.size() || this->dataMin.empty())
+        throw std::invalid_argument("A scaler needs one minimum and one maximum per column!");
+    if (!this->columns.empty() && this->columns.size() != this->dataMin.size())
+        throw std::invalid_argument("A scaler needs one name per column!");
+    if (lower >= upper)
+        throw std::invalid_argument("Invalid feature range!");
+    for (size_t i = 0; i < this->dataMin.size(); i ++) {
+        const double range = this->dataMax[i] - this->dataMin[i];
+        this->scale.push_back((upper - lower) / (range == 0. ? 1. : range));
+        this->offset.push_back(lower - this->dataMin[i] * this->scale.back());
+    }
+}
+
+void Scaler::save(const std::string &path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file!" << std::endl;
+        return;
+    }
+    const auto writeNumbers = [&file](const std::vector<double>& numbers) {
+        file << "[";
+        for (size_t i = 0; i < numbers.size(); i ++) {
+            file << numbers[i] << (i + 1 != numbers.size() ? ", " : "");
+        }
+        file << "]";
+    };
+    file << std::setprecision(std::numeric_limits<double>::max_digits10) << "{\"columns\": [";
+    for (size_t i = 0; i < this->columns.size(); i ++) {
+        file << "\"" << this->columns[i] << "\"" << (i + 1 != this->columns.size() ? ", " : "");
+    }
+    file << "], \"data_min\": ";
+    writeNumbers(this->dataMin);
+    file << ", \"data_max\": ";
+    writeNumbers(this->dataMax);
+    file << ", \"feature_range\": [" << this->lower << ", " << this->upper << "]}\n";
+    file.close();
+}
+
+void Scaler::transform(const double *input, double *output) const {
+    size_t i = 0;
+#if defined(__AVX2__)
+    // a separate multiply and add, not an FMA, to round like the scalar path and numpy
+    for (; i + 4 <= this->size(); i += 4) {
+        const __m256d scaled = _mm256_mul_pd(_mm256_loadu_pd(input + i), _mm256_loadu_pd(this->scale.data() + i));
+        _mm256_storeu_pd(output + i, _mm256_add_pd(scaled, _mm256_loadu_pd(this->offset.data() + i)));
+    }
+#endif
+    for (; i < this->size(); i ++) {
+        output[i] = input[i] * this->scale[i] + this->offset[i];
+    }
+}
+
+void Scaler::inverseTransform(const double *input, double *output) const {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= this->size(); i += 4) {
+        const __m256d shifted = _mm256_sub_pd(_mm256_loadu_pd(input + i), _mm256_loadu_pd(this->offset.data() + i));
+        _mm256_storeu_pd(output + i, _mm256_div_pd(shifted, _mm256_loadu_pd(this->scale.data() + i)));
+    }
+#endif
+    for (; i < this->size(); i ++) {
+        output[i] = (input[i] - this->offset[i]) / this->scale[i];
+    }
+}
+
+void Scaler::foldInto(Model &model) const {
+    const std::shared_ptr<InputLayer> inputLayer = model.getInputLayer();
+    const Matrix weights = inputLayer->getWeight();
+    const Matrix biases = inputLayer->getBiases();
+    if (weights.getColumnSize() != this->size())
+        throw std::invalid_argument("The scaler doesn't have one column per model input!");
+
+    std::vector<std::unique_ptr<std::vector<double>>> foldedWeights(weights.getRowSize());
+    std::vector<double> foldedBiases(weights.getRowSize());
+    for (size_t i = 0; i < weights.getRowSize(); i ++) {
+        foldedWeights[i] = std::make_unique<std::vector<double>>(this->size());
+        foldedBiases[i] = biases(i, 0);
+        for (size_t k = 0; k < this->size(); k ++) {
+            (*foldedWeights[i])[k] = weights(i, k) * this->scale[k];
+            foldedBiases[i] += weights(i, k) * this->offset[k];
+        }
+    }
+    model.setInputParameters(Matrix(std::move(foldedWeights)), Matrix::columnVector(foldedBiases));
+}
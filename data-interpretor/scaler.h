@@ -0,0 +1,66 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_SCALER_H
+#define F1_STRATEGIES_SCALER_H
+
+#include <string>
+#include <vector>
+
+class Model;
+
+/* Range one column was min-max scaled with */
+struct FeatureRange {
+    double min = 0.;
+    double max = 1.;
+    double scale(const double& value) const { return this->max == this->min ? 0. : (value - this->min) / (this->max - this->min); }
+    double unscale(const double& value) const { return this->min + value * (this->max - this->min); }
+};
+
+/*
+ * Native counterpart of the MinMaxScalers fitted in collect_data.py, so raw features can be scaled and predictions
+ * unscaled without Python. Like scikit-learn, x_scaled = x * scale + offset with scale = (upper - lower) / (max - min)
+ * (1 / 1 for a constant column) and offset = lower - min * scale, and the inverse is (x - offset) / scale, so the
+ * results match joblib's to the last bit. The parameters are read from and written to the small JSON file
+ * collect_data.py writes next to its joblib dumps:
+ *
+ *   {"columns": ["LapTime_ms", ...], "data_min": [...], "data_max": [...], "feature_range": [0, 1]}
+ * */
+class Scaler {
+public:
+    static Scaler load(const std::string& path);
+
+    Scaler() = default;
+    Scaler(std::vector<double> dataMin, std::vector<double> dataMax, std::vector<std::string> columns = {},
+           const double& lower = 0., const double& upper = 1.);
+    ~Scaler() = default;
+
+    void save(const std::string& path) const;
+
+    /* size() values from input to output, which may be the same buffer, 4 per instruction with AVX2 */
+    void transform(const double* input, double* output) const;
+    void inverseTransform(const double* input, double* output) const;
+
+    /*
+     * Folds the scaling into the model's input layer (x -> W (x * scale + offset) + b is still an affine layer),
+     * so the model takes raw features and no pass over the inputs is left at inference. A model saved afterwards
+     * keeps taking raw features.
+     * */
+    void foldInto(Model& model) const;
+
+    [[nodiscard]] FeatureRange getRange(const size_t& column) const { return {this->dataMin[column], this->dataMax[column]}; }
+    [[nodiscard]] const std::vector<std::string>& getColumns() const { return this->columns; }
+    [[nodiscard]] size_t size() const { return this->dataMin.size(); }
+
+private:
+    std::vector<double> dataMin;
+    std::vector<double> dataMax;
+    std::vector<std::string> columns;
+    double lower = 0.;
+    double upper = 1.;
+    std::vector<double> scale;
+    std::vector<double> offset;
+};
+
+#endif //F1_STRATEGIES_SCALER_H
@@ -0,0 +1,158 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "session-replay.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+SessionReplay SessionReplay::load(const std::string &path) {
+    std::ifstream file(path);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open file \"" + path + "\"");
+
+    SessionReplay replay;
+    TimingParser parser;
+    std::vector<std::string> lines;
+    std::vector<double> times;
+    std::array<double, FEATURE_COUNT> minimums, maximums;
+    SectorDecay decayMinimums, decayMaximums;
+    minimums.fill(std::numeric_limits<double>::infinity());
+    maximums.fill(-std::numeric_limits<double>::infinity());
+    decayMinimums.fill(std::numeric_limits<double>::infinity());
+    decayMaximums.fill(-std::numeric_limits<double>::infinity());
+
+    std::string line, session;
+    std::map<int, double> driverTimes;      // time at which each driver completed their last lap of the session
+    double sessionStart = 0., sessionEnd = 0.;
+    while (std::getline(file, line)) {
+        const std::optional<TimingRecord> record = parser.parse(line);
+        if (!record) continue;
+
+        const std::string lineSession = line.substr(0, line.find(','));
+        if (lineSession != session) {
+            session = lineSession;
+            sessionStart = sessionEnd;
+            driverTimes.clear();
+        }
+        auto [it, inserted] = driverTimes.try_emplace(record->driver, sessionStart);
+        it->second += record->lapTimeMs;
+        sessionEnd = std::max(sessionEnd, it->second);
+        times.push_back(it->second);
+
+        // the drivers and teams are sent with the codes pd.factorize gives them, in file order
+        std::vector<std::string> columns;
+        size_t start = 0, comma;
+        while ((comma = line.find(',', start)) != std::string::npos) {
+            columns.push_back(line.substr(start, comma - start));
+            start = comma + 1;
+        }
+        columns.push_back(line.substr(start));
+        columns[13] = std::to_string(record->driver);
+        columns[14] = std::to_string(record->team);
+        std::string encoded;
+        for (size_t i = 0; i < columns.size(); i ++) {
+            encoded += columns[i] + (i + 1 != columns.size() ? "," : "\n");
+        }
+        lines.push_back(std::move(encoded));
+
+        const std::array<double, FEATURE_COUNT> features = record->features();
+        for (size_t i = 0; i < FEATURE_COUNT; i ++) {
+            minimums[i] = std::min(minimums[i], features[i]);
+            maximums[i] = std::max(maximums[i], features[i]);
+        }
+        for (size_t s = 0; s < SECTOR_COUNT && record->decayRatesMs; s ++) {
+            decayMinimums[s] = std::min(decayMinimums[s], (*record->decayRatesMs)[s]);
+            decayMaximums[s] = std::max(decayMaximums[s], (*record->decayRatesMs)[s]);
+        }
+    }
+    if (lines.empty())
+        throw std::invalid_argument("\"" + path + "\" holds no lap record.");
+
+    std::vector<size_t> order(lines.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&times](const size_t& a, const size_t& b) { return times[a] < times[b]; });
+    for (const size_t& i : order) {
+        replay.lines.push_back(std::move(lines[i]));
+        replay.scheduleMs.push_back(times[i]);
+    }
+    replay.inputScaler = Scaler(std::vector<double>(minimums.begin(), minimums.end()), std::vector<double>(maximums.begin(), maximums.end()));
+    for (size_t s = 0; s < SECTOR_COUNT; s ++) {
+        // a session without decay rates keeps the predictions as they are
+        if (decayMinimums[s] > decayMaximums[s]) {
+            decayMinimums[s] = 0.;
+            decayMaximums[s] = 1.;
+        }
+    }
+    replay.outputScaler = Scaler(std::vector<double>(decayMinimums.begin(), decayMinimums.end()), std::vector<double>(decayMaximums.begin(), decayMaximums.end()));
+    return replay;
+}
+
+int SessionReplay::connect(const std::string &socketPath) {
+    sockaddr_un address {};
+    if (socketPath.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument("Socket path \"" + socketPath + "\" is too long.");
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    const int connection = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0)
+        throw std::runtime_error("Couldn't create a socket: " + std::string(std::strerror(errno)));
+    if (::connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        const std::string error = std::strerror(errno);
+        ::close(connection);
+        throw std::runtime_error("Couldn't connect to \"" + socketPath + "\": " + error);
+    }
+    return connection;
+}
+
+ReplayStats SessionReplay::play(const int &fileDescriptor, const double &speed, const double &maxGapMs) const {
+    if (speed < 0)
+        throw std::invalid_argument("The replay speed can't be negative!");
+
+    ReplayStats stats;
+    LatencyRecorder lateness;
+    const auto start = std::chrono::steady_clock::now();
+    double replayTimeMs = 0.;
+    for (size_t i = 0; i < this->lines.size(); i ++) {
+        std::chrono::steady_clock::time_point target = std::chrono::steady_clock::now();
+        if (speed != REPLAY_UNTHROTTLED) {
+            if (i > 0) replayTimeMs += std::min(this->scheduleMs[i] - this->scheduleMs[i - 1], maxGapMs);
+            target = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double, std::milli>(replayTimeMs / speed));
+            std::this_thread::sleep_until(target);
+        }
+        const std::string& line = this->lines[i];
+        size_t written = 0;
+        while (written < line.size()) {
+            // a reader that left ends the replay instead of killing the process with a SIGPIPE
+            const ssize_t size = ::send(fileDescriptor, line.data() + written, line.size() - written, MSG_NOSIGNAL);
+            if (size < 0 && errno == EINTR) continue;
+            if (size < 0 && (errno == EPIPE || errno == ECONNRESET)) {
+                stats.readerLeft = true;
+                break;
+            }
+            if (size < 0)
+                throw std::runtime_error("Couldn't write the replay: " + std::string(std::strerror(errno)));
+            written += size;
+        }
+        if (stats.readerLeft) break;
+        lateness.record(std::chrono::steady_clock::now() - target);
+        stats.records ++;
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.recordsPerSecond = stats.seconds > 0 ? (double)stats.records / stats.seconds : 0.;
+    stats.lateness = lateness.summary();
+    return stats;
+}
@@ -0,0 +1,56 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_SESSION_REPLAY_H
+#define F1_STRATEGIES_SESSION_REPLAY_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "./latency.h"
+#include "./scaler.h"
+#include "./timing-record.h"
+
+/* REPLAY MACROS */
+#define REPLAY_UNTHROTTLED 0.               // speed at which the records are written back to back
+
+struct ReplayStats {
+    size_t records = 0;
+    double seconds = 0.;
+    double recordsPerSecond = 0.;
+    bool readerLeft = false;                // the socket was closed on the other end before the last record
+    LatencySummary lateness;                // how late each record was written compared to its schedule
+};
+
+/*
+ * A historical session CSV (the schema collect_data.py writes) played back as a live feed. The CSV has no
+ * timestamps, so a lap is scheduled when its driver would have completed it: the sum of the driver's lap times
+ * so far in the session, the sessions following each other. Gaps between consecutive records can be capped
+ * (e.g. the pit lane, the breaks between sessions) and the whole schedule played faster.
+ * */
+class SessionReplay {
+public:
+    static SessionReplay load(const std::string& path);
+    /* connects to a LiveFeed listening on a Unix domain socket */
+    static int connect(const std::string& socketPath);
+
+    /* writes every record to the socket, speed 1 for real time, 10 for 10x, REPLAY_UNTHROTTLED; stops early if the reader leaves */
+    ReplayStats play(const int& fileDescriptor, const double& speed, const double& maxGapMs) const;
+
+    /* what the MinMaxScalers of collect_data.py fit on the session */
+    [[nodiscard]] const Scaler& getInputScaler() const { return this->inputScaler; }
+    [[nodiscard]] const Scaler& getOutputScaler() const { return this->outputScaler; }
+    [[nodiscard]] size_t size() const { return this->lines.size(); }
+
+private:
+    SessionReplay() = default;
+
+    std::vector<std::string> lines;         // with their '\n', in schedule order
+    std::vector<double> scheduleMs;         // original time of each line since the start of the first session
+    Scaler inputScaler;
+    Scaler outputScaler;
+};
+
+#endif //F1_STRATEGIES_SESSION_REPLAY_H
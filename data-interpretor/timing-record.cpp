@@ -0,0 +1,91 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "timing-record.h"
+
+#include <charconv>
+#include <vector>
+
+/* Utility functions */
+bool parseNumber(const std::string_view& value, double& result) {
+    if (value.empty()) return false;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+    return error == std::errc() && end == value.data() + value.size();
+}
+
+std::optional<Compound> parseCompound(const std::string_view& value) {
+    static const std::array<std::string_view, COMPOUND_COUNT> names = {"SOFT", "MEDIUM", "HARD", "INTERMEDIATE", "WET"};
+    for (int c = 0; c < COMPOUND_COUNT; c ++) {
+        if (value == names[c]) return static_cast<Compound>(c);
+    }
+    double code;
+    if (parseNumber(value, code) && code >= 0 && code < COMPOUND_COUNT) return static_cast<Compound>((int)code);
+    return std::nullopt;
+}
+
+std::array<double, FEATURE_COUNT> TimingRecord::features() const {
+    std::array<double, FEATURE_COUNT> features {};
+    features[FEATURE_LAP_TIME] = this->lapTimeMs;
+    features[FEATURE_LAP_NUMBER] = this->lapNumber;
+    features[FEATURE_STINT] = this->stint;
+    features[FEATURE_SECTOR_1_TIME] = this->sectorTimesMs[0];
+    features[FEATURE_SECTOR_2_TIME] = this->sectorTimesMs[1];
+    features[FEATURE_SECTOR_3_TIME] = this->sectorTimesMs[2];
+    features[FEATURE_SPEED_I1] = this->speeds[0];
+    features[FEATURE_SPEED_I2] = this->speeds[1];
+    features[FEATURE_SPEED_FL] = this->speeds[2];
+    features[FEATURE_SPEED_ST] = this->speeds[3];
+    features[FEATURE_COMPOUND] = static_cast<double>(this->compound);
+    features[FEATURE_TYRE_LIFE] = this->tyreLife;
+    features[FEATURE_DRIVER] = this->driver;
+    features[FEATURE_TEAM] = this->team;
+    return features;
+}
+
+std::optional<TimingRecord> TimingParser::parse(std::string_view line) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    std::vector<std::string_view> columns;
+    size_t start = 0;
+    while (true) {
+        const size_t comma = line.find(',', start);
+        columns.push_back(line.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start));
+        if (comma == std::string_view::npos) break;
+        start = comma + 1;
+    }
+    if (columns.size() < TIMING_RECORD_COLUMNS) return std::nullopt;
+
+    // columns 1 to 10 and 12 are numbers
+    std::array<double, TIMING_RECORD_COLUMNS> numbers {};
+    for (size_t i = 1; i <= 12; i ++) {
+        if (i == 11) continue;
+        if (!parseNumber(columns[i], numbers[i])) return std::nullopt;
+    }
+    const std::optional<Compound> compound = parseCompound(columns[11]);
+    if (!compound || columns[0].empty() || columns[13].empty() || columns[14].empty()) return std::nullopt;
+
+    TimingRecord record {};
+    record.lapTimeMs = numbers[1];
+    record.lapNumber = (int)numbers[2];
+    record.stint = (int)numbers[3];
+    record.sectorTimesMs = {numbers[4], numbers[5], numbers[6]};
+    record.speeds = {numbers[7], numbers[8], numbers[9], numbers[10]};
+    record.compound = *compound;
+    record.tyreLife = (int)numbers[12];
+    record.session = TimingParser::factorize(this->sessions, columns[0]);
+    record.driver = TimingParser::factorize(this->drivers, columns[13]);
+    record.team = TimingParser::factorize(this->teams, columns[14]);
+    SectorDecay decayRates;
+    if (columns.size() >= TIMING_RECORD_COLUMNS + SECTOR_COUNT && parseNumber(columns[15], decayRates[0])
+        && parseNumber(columns[16], decayRates[1]) && parseNumber(columns[17], decayRates[2])) {
+        record.decayRatesMs = decayRates;
+    }
+    return record;
+}
+
+int TimingParser::factorize(std::unordered_map<std::string, int> &codes, const std::string_view &value) {
+    double code;
+    if (parseNumber(value, code)) return (int)code;
+    const auto [it, inserted] = codes.try_emplace(std::string(value), (int)codes.size());
+    return it->second;
+}
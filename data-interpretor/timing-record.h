@@ -0,0 +1,62 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_TIMING_RECORD_H
+#define F1_STRATEGIES_TIMING_RECORD_H
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../strategy/features.h"
+
+/* TIMING RECORD MACROS */
+#define TIMING_RECORD_COLUMNS 15            // Session to Team in collect_data.py's features, the decay rates are optional
+
+/* One completed lap of one car, as timed live */
+struct TimingRecord {
+    std::chrono::steady_clock::time_point arrival;      // when the line was read, for latency measurements
+    int session;                                        // numbered like the drivers, see TimingParser
+    int driver;
+    int team;
+    int lapNumber;
+    int stint;
+    double lapTimeMs;
+    std::array<double, SECTOR_COUNT> sectorTimesMs;
+    std::array<double, 4> speeds;                       // SpeedI1, SpeedI2, SpeedFL, SpeedST
+    Compound compound;
+    int tyreLife;
+    std::optional<SectorDecay> decayRatesMs;            // only in historical sessions, see collect_data.py
+
+    /* the record as one unscaled model input, columns ordered as in features.h */
+    [[nodiscard]] std::array<double, FEATURE_COUNT> features() const;
+};
+
+/*
+ * Reads the lines of the session CSV written by collect_data.py (Session, LapTime_ms, LapNumber, Stint,
+ * Sector1-3Time_ms, SpeedI1, SpeedI2, SpeedFL, SpeedST, Compound, TyreLife, Driver, Team, then optionally the
+ * decay rates). Sessions, drivers and teams are numbered in order of first appearance, like pd.factorize, so a
+ * feed that replays the training session gets the same codes as the training data. Numeric codes are taken as
+ * they are.
+ * */
+class TimingParser {
+public:
+    TimingParser() = default;
+    ~TimingParser() = default;
+
+    /* nothing for the header or a malformed line */
+    std::optional<TimingRecord> parse(std::string_view line);
+
+private:
+    static int factorize(std::unordered_map<std::string, int>& codes, const std::string_view& value);
+
+    std::unordered_map<std::string, int> sessions;
+    std::unordered_map<std::string, int> drivers;
+    std::unordered_map<std::string, int> teams;
+};
+
+#endif //F1_STRATEGIES_TIMING_RECORD_H
@@ -7,13 +7,43 @@
  *
  * */
 
+#include <cstdlib>
 #include <iostream>
+#include <string>
 #include <OpenCL/opencl.h>
 
 #include "./neural-network/model.h"
+#include "./neural-network/quantized-model.h"
+#include "./neural-network/cross-validation.h"
 #include "./data-interpretor/data-loader.h"
+#include "./strategy/features.h"
 
-int main() {
+/* TRAINING MACROS */
+#define CHECKPOINT_PATH "../file.checkpoint"
+#define CHECKPOINT_INTERVAL 5
+#define GROUPS_PATH "../groups-preprocessed-data.csv"     // written by collect_data.py, session then driver per lap
+#define CROSS_VALIDATION_SEED 0
+
+int main(int argc, char* argv[]) {
+
+    // --resume <checkpoint> carries on an interrupted training, checkpoints are written every CHECKPOINT_INTERVAL epochs
+    // --cross-validate <k> only estimates the model's error over k folds, kept apart by driver, session or not at all
+    // --save-as <name> saves the model under another name than file.model, e.g. the members of an ensemble
+    std::string resumePath, groupBy = "driver", modelName = "file.model";
+    size_t foldCount = 0, threadCount = 0;
+    for (int i = 1; i < argc; i ++) {
+        const std::string argument = argv[i];
+        if (argument == "--resume" && i + 1 < argc) resumePath = argv[++ i];
+        else if (argument == "--cross-validate" && i + 1 < argc) foldCount = std::stoul(argv[++ i]);
+        else if (argument == "--group-by" && i + 1 < argc) groupBy = argv[++ i];
+        else if (argument == "--threads" && i + 1 < argc) threadCount = std::stoul(argv[++ i]);
+        else if (argument == "--save-as" && i + 1 < argc) modelName = argv[++ i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--resume <checkpoint>] [--cross-validate <k> [--group-by driver|session|none] [--threads <n>]]"
+                      << " [--save-as <name>]" << std::endl;
+            return 1;
+        }
+    }
 
     /* Test Spanish GP tyre decay rate */
 
@@ -25,6 +55,37 @@ int main() {
     auto X = DataLoader::generateVectors(Xdata);
     auto Y = DataLoader::generateVectors(Ydata);
 
+    if (foldCount) {
+        std::vector<long> groups;
+        if (groupBy == "driver") groups = groupsFromFeature(X, FEATURE_DRIVER);
+        else if (groupBy == "session") {
+            const std::pair<std::vector<float>, size_t> groupData = DataLoader::load(GROUPS_PATH);
+            for (size_t i = 0; i < groupData.first.size(); i += groupData.second) groups.push_back((long)groupData.first[i]);
+        } else if (groupBy != "none") {
+            std::cerr << "Unknown grouping " << groupBy << ", expected driver, session or none" << std::endl;
+            return 1;
+        }
+        TrainingConfiguration configuration;
+        configuration.hiddenLayers = {64, 64, 9};
+        configuration.activation = std::make_shared<TanH>(0.01);
+        configuration.optimizer = OptimizerKind::RMSPROP;
+        configuration.learningRate = 0.005;
+        configuration.batchSize = 3;
+        configuration.lambda = 0.1;
+        const std::vector<Fold> folds = makeFolds(X.size(), foldCount, groups, CROSS_VALIDATION_SEED);
+        crossValidate(configuration, 100, X, Y, folds, threadCount).print(std::cout);
+        return 0;
+    }
+
+    // the last laps are held out, training stops once their loss hasn't improved for 10 epochs
+    const size_t trainingSize = X.size() - X.size() / 10;
+    const std::vector<Matrix> validationX(X.begin() + (long)trainingSize, X.end());
+    const std::vector<Matrix> validationY(Y.begin() + (long)trainingSize, Y.end());
+    X.erase(X.begin() + (long)trainingSize, X.end());
+    Y.erase(Y.begin() + (long)trainingSize, Y.end());
+    EarlyStopping earlyStopping;
+    earlyStopping.patience = 10;
+
     Model TyreModel = Model(14, TanH(0.01), std::make_unique<MSE>(0.1));
     TyreModel.addLayer(TanH(0.01), 64);
     TyreModel.addLayer(TanH(0.01), 64);
@@ -32,8 +93,17 @@ int main() {
     TyreModel.addLayer(TanH(0.01), 3);
 
     TyreModel.selectOptimiser(std::make_unique<RMSPROP>(0.005));
-    TyreModel.trainNetwork(X, Y, 100, 3);
+    TyreModel.setCheckpoints(CHECKPOINT_PATH, CHECKPOINT_INTERVAL);
+    if (!resumePath.empty()) TyreModel.resume(resumePath);
+
+    // F1_PROFILE=1 breaks every epoch down per phase and layer, F1_PROFILE_TRACE=<path> also writes a Chrome trace
+    const char* tracePath = std::getenv("F1_PROFILE_TRACE");
+    if (std::getenv("F1_PROFILE") || tracePath) Profiler::enable(true, tracePath != nullptr);
+    TyreModel.trainNetwork(X, Y, 100, 3, validationX, validationY, earlyStopping);
+    if (tracePath) Profiler::writeTrace(tracePath);
+    TyreModel.getEpochErrors().print(std::cout, "Last epoch absolute error, sector");
 
-    TyreModel.save("file.model");
+    TyreModel.save(modelName);
+    QuantizedModel(TyreModel, X, QUANTIZATION_CALIBRATION_SAMPLES).save(modelName);
     std::cout << "Model Saved!";
 }
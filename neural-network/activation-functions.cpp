@@ -9,10 +9,42 @@ std::ostream& operator << (std::ostream& o, const ActivationFunction& f) {
     return o;
 }
 
+void ActivationFunction::applyBatch(const double *input, double *output, const size_t &size) const {
+    for (size_t i = 0; i < size; i ++) {
+        output[i] = this->apply(input[i]);
+    }
+}
+
+/* Utility function */
+template <typename F>
+Matrix mapBatched(const Matrix& inputs, F batch) {
+    /* gathers the matrix into one contiguous buffer so the batched approximations can use SIMD */
+    thread_local std::vector<double> buffer;
+    const size_t rows = inputs.getRowSize(), columns = inputs.getColumnSize();
+    buffer.resize(rows * columns);
+    for (size_t i = 0; i < rows; i ++) {
+        for (size_t j = 0; j < columns; j ++) {
+            buffer[i * columns + j] = inputs(i, j);
+        }
+    }
+    batch(buffer.data(), buffer.data(), buffer.size());
+    Matrix::Rows data = Matrix::allocateRows(rows, columns);
+    for (size_t i = 0; i < rows; i ++) {
+        std::copy(buffer.begin() + i * columns, buffer.begin() + (i + 1) * columns, data[i].begin());
+    }
+    return Matrix(std::move(data));
+}
+
 
 /* No Activation */
 Matrix NoActivation::function(const Matrix &inputs) { return inputs; }
 
+double NoActivation::apply(const double &input) const { return input; }
+
+void NoActivation::applyBatch(const double *input, double *output, const size_t &size) const {
+    if (input != output) std::copy(input, input + size, output);
+}
+
 double NoActivation::derivative(const double &input) { return input; }
 
 std::unique_ptr<ActivationFunction> NoActivation::clone() const {
@@ -25,10 +57,20 @@ void NoActivation::print(std::ostream& o) const {
 
 /* Rectified linear (ReLU) */
 Matrix ReLU::function(const Matrix &inputs) {
-    auto f = [](double x) { return std::max(0.0, x); };
+    auto f = [this](double x) { return this->ReLU::apply(x); };
     return inputs.map(f);
 }
 
+double ReLU::apply(const double &input) const {
+    return std::max(0.0, input);
+}
+
+void ReLU::applyBatch(const double *input, double *output, const size_t &size) const {
+    for (size_t i = 0; i < size; i ++) {
+        output[i] = this->ReLU::apply(input[i]);
+    }
+}
+
 double ReLU::derivative(const double &input) {
     return (double)(input > 0);
 }
@@ -43,10 +85,20 @@ void ReLU::print(std::ostream& o) const {
 
 /* Leaky Rectified Linear (Leaky ReLU) */
 Matrix LeakyReLU::function(const Matrix &inputs) {
-    auto f = [this](double x) { return x >= 0 ? x : this->_alpha * x; };
+    auto f = [this](double x) { return this->LeakyReLU::apply(x); };
     return inputs.map(f);
 }
 
+double LeakyReLU::apply(const double &input) const {
+    return input >= 0 ? input : this->_alpha * input;
+}
+
+void LeakyReLU::applyBatch(const double *input, double *output, const size_t &size) const {
+    for (size_t i = 0; i < size; i ++) {
+        output[i] = this->LeakyReLU::apply(input[i]);
+    }
+}
+
 double LeakyReLU::derivative(const double &input) {
     return input < 0 ? this->_alpha : (double) input != 0.;
 }
@@ -61,11 +113,32 @@ void LeakyReLU::print(std::ostream& o) const {
 
 /* Exponential Linear Unit (ELU) */
 Matrix ELU::function(const Matrix &inputs) {
-    auto f = [this](double x) { return x >= 0 ? x : this->_alpha * (std::exp(x) - 1); };
+    if (this->_approximate) {
+        return mapBatched(inputs, [this](const double* input, double* output, const size_t& size) {
+            fastMath::elu(input, output, size, this->_alpha);
+        });
+    }
+    auto f = [this](double x) { return this->ELU::apply(x); };
     return inputs.map(f);
 }
 
+double ELU::apply(const double &input) const {
+    if (this->_approximate) return input >= 0 ? input : this->_alpha * (fastMath::exp(input) - 1);
+    return input >= 0 ? input : this->_alpha * (std::exp(input) - 1);
+}
+
+void ELU::applyBatch(const double *input, double *output, const size_t &size) const {
+    if (this->_approximate) {
+        fastMath::elu(input, output, size, this->_alpha);
+        return;
+    }
+    for (size_t i = 0; i < size; i ++) {
+        output[i] = this->ELU::apply(input[i]);
+    }
+}
+
 double ELU::derivative(const double &input) {
+    if (this->_approximate) return input < 0 ? this->_alpha * fastMath::exp(input) : 1.;
     return input < 0 ? this->_alpha * std::exp(input) : 1.;
 }
 
@@ -74,16 +147,40 @@ std::unique_ptr<ActivationFunction> ELU::clone() const {
 }
 
 void ELU::print(std::ostream& o) const {
-    o << "ELU, alpha = " << this->_alpha;
+    o << "ELU, alpha = " << this->_alpha << (this->_approximate ? ", approximate" : "");
 }
 
 /* Tanh */
 Matrix TanH::function(const Matrix &inputs) {
-    auto f = [](double x) { return std::tanh(x); };
+    if (this->_approximate) {
+        return mapBatched(inputs, [](const double* input, double* output, const size_t& size) {
+            fastMath::tanh(input, output, size);
+        });
+    }
+    auto f = [this](double x) { return this->TanH::apply(x); };
     return inputs.map(f);
 }
 
+double TanH::apply(const double &input) const {
+    if (this->_approximate) return fastMath::tanh(input);
+    return std::tanh(input);
+}
+
+void TanH::applyBatch(const double *input, double *output, const size_t &size) const {
+    if (this->_approximate) {
+        fastMath::tanh(input, output, size);
+        return;
+    }
+    for (size_t i = 0; i < size; i ++) {
+        output[i] = this->TanH::apply(input[i]);
+    }
+}
+
 double TanH::derivative(const double &input) {
+    if (this->_approximate) {
+        const double tanh = fastMath::tanh(input);
+        return 1 - (tanh * tanh);
+    }
     const double tanh = (std::exp(input) - std::exp(-input)) / (std::exp(input) + std::exp(-input));
     return 1 - (tanh * tanh);
 }
@@ -93,17 +190,37 @@ std::unique_ptr<ActivationFunction> TanH::clone() const {
 }
 
 void TanH::print(std::ostream& o) const {
-    o << "TanH, alpha = " << this->_alpha;
+    o << "TanH, alpha = " << this->_alpha << (this->_approximate ? ", approximate" : "");
 }
 
 /* Sigmoid */
 Matrix Sigmoid::function(const Matrix &inputs) {
-    auto f = [](double x) { return 1 / (1 + std::exp(-x)); };
+    if (this->_approximate) {
+        return mapBatched(inputs, [](const double* input, double* output, const size_t& size) {
+            fastMath::sigmoid(input, output, size);
+        });
+    }
+    auto f = [this](double x) { return this->Sigmoid::apply(x); };
     return inputs.map(f);
 }
 
+double Sigmoid::apply(const double &input) const {
+    if (this->_approximate) return fastMath::sigmoid(input);
+    return 1 / (1 + std::exp(-input));
+}
+
+void Sigmoid::applyBatch(const double *input, double *output, const size_t &size) const {
+    if (this->_approximate) {
+        fastMath::sigmoid(input, output, size);
+        return;
+    }
+    for (size_t i = 0; i < size; i ++) {
+        output[i] = this->Sigmoid::apply(input[i]);
+    }
+}
+
 double Sigmoid::derivative(const double &input) {
-    const double sigmoidBase = 1 / (1 + std::exp(-input));
+    const double sigmoidBase = this->_approximate ? fastMath::sigmoid(input) : 1 / (1 + std::exp(-input));
     return sigmoidBase * (1 - sigmoidBase);
 }
 
@@ -112,5 +229,5 @@ std::unique_ptr<ActivationFunction> Sigmoid::clone() const {
 }
 
 void Sigmoid::print(std::ostream& o) const {
-    o << "Sigmoid";
+    o << "Sigmoid" << (this->_approximate ? ", approximate" : "");
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <ostream>
 
 #include "./matrix.h"
+#include "./fast-math.h"
 
 class ActivationFunction {
 public:
@@ -17,6 +18,10 @@ public:
     ~ActivationFunction() = default;
     ActivationFunction(const ActivationFunction& o) = default;
     virtual Matrix function(const Matrix& inputs) = 0;
+    /* function applied to a single value */
+    virtual double apply(const double& input) const = 0;
+    /* function applied to size contiguous values, input and output may be the same buffer */
+    virtual void applyBatch(const double* input, double* output, const size_t& size) const;
     virtual double derivative(const double& input) = 0;
     virtual std::unique_ptr<ActivationFunction> clone() const = 0;
     friend std::ostream& operator << (std::ostream& o, const ActivationFunction& f);
@@ -29,6 +34,8 @@ public:
     ~NoActivation() = default;
     NoActivation(const NoActivation& o) = default;
     Matrix function(const Matrix& inputs) override;
+    double apply(const double& input) const override;
+    void applyBatch(const double* input, double* output, const size_t& size) const override;
     double derivative(const double& input) override;
     std::unique_ptr<ActivationFunction> clone() const override;
 private:
@@ -40,6 +47,8 @@ public:
     ReLU() = default;
     ~ReLU() = default;
     Matrix function(const Matrix& inputs) override;
+    double apply(const double& input) const override;
+    void applyBatch(const double* input, double* output, const size_t& size) const override;
     double derivative(const double& input) override;
     std::unique_ptr<ActivationFunction> clone() const override;
 private:
@@ -50,47 +59,67 @@ public:
     explicit LeakyReLU(const double& alpha): _alpha(alpha) {}
     ~LeakyReLU() = default;
     Matrix function(const Matrix& inputs) override;
+    double apply(const double& input) const override;
+    void applyBatch(const double* input, double* output, const size_t& size) const override;
     double derivative(const double& input) override;
     std::unique_ptr<ActivationFunction> clone() const override;
+    [[nodiscard]] double getAlpha() const { return this->_alpha; }
 private:
     void print(std::ostream& o) const override;
     const double _alpha;
 };
 
+/*
+ * ELU, TanH and Sigmoid take an optional `approximate` flag, which swaps libm's exp/tanh for the branch-free
+ * approximations of fast-math.h (error bounds documented there) in function, apply and derivative.
+ * */
 class ELU: public ActivationFunction {
 public:
-    explicit ELU(const double& alpha): _alpha(alpha) {}
+    explicit ELU(const double& alpha, const bool& approximate = false): _alpha(alpha), _approximate(approximate) {}
     ~ELU() = default;
     Matrix function(const Matrix& inputs) override;
+    double apply(const double& input) const override;
+    void applyBatch(const double* input, double* output, const size_t& size) const override;
     double derivative(const double& input) override;
     std::unique_ptr<ActivationFunction> clone() const override;
+    [[nodiscard]] double getAlpha() const { return this->_alpha; }
+    [[nodiscard]] bool isApproximate() const { return this->_approximate; }
 private:
     void print(std::ostream& o) const override;
     const double _alpha;
+    const bool _approximate;
 };
 
 class TanH: public ActivationFunction {
 public:
-    explicit TanH(const double& alpha): _alpha(alpha) {}
+    explicit TanH(const double& alpha, const bool& approximate = false): _alpha(alpha), _approximate(approximate) {}
     ~TanH() = default;
     Matrix function(const Matrix& inputs) override;
+    double apply(const double& input) const override;
+    void applyBatch(const double* input, double* output, const size_t& size) const override;
     double derivative(const double& input) override;
     std::unique_ptr<ActivationFunction> clone() const override;
+    [[nodiscard]] bool isApproximate() const { return this->_approximate; }
 
 private:
     void print(std::ostream& o) const override;
     const double _alpha;
+    const bool _approximate;
 };
 
 class Sigmoid: public ActivationFunction {
 public:
-    Sigmoid() = default;
+    explicit Sigmoid(const bool& approximate = false): _approximate(approximate) {}
     ~Sigmoid() = default;
     Matrix function(const Matrix& inputs) override;
+    double apply(const double& input) const override;
+    void applyBatch(const double* input, double* output, const size_t& size) const override;
     double derivative(const double& input) override;
     std::unique_ptr<ActivationFunction> clone() const override;
+    [[nodiscard]] bool isApproximate() const { return this->_approximate; }
 private:
     void print(std::ostream& o) const override;
+    const bool _approximate;
 };
 
 #endif // ACTIVATION_FUNCTIONS_H
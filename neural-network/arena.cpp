@@ -0,0 +1,49 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "arena.h"
+
+#include <algorithm>
+
+thread_local StepArena* StepArena::active = nullptr;
+std::atomic<size_t> StepArena::heapAllocations {0};
+
+void* StepArena::allocate(const size_t &bytes) {
+    const size_t size = (bytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    while (this->block < this->blocks.size() && this->offset + size > this->blocks[this->block].size) {
+        this->block ++;
+        this->offset = 0;
+    }
+    if (this->block == this->blocks.size()) {
+        // new blocks go last, so the ones reused after a reset stay in the same order
+        const size_t blockSize = std::max<size_t>(ARENA_BLOCK_SIZE, size);
+        this->blocks.push_back({std::make_unique<std::byte[]>(blockSize), blockSize});
+        StepArena::countHeapAllocation();
+        this->offset = 0;
+    }
+    void* pointer = this->blocks[this->block].memory.get() + this->offset;
+    this->offset += size;
+    return pointer;
+}
+
+void StepArena::reset() {
+    this->block = 0;
+    this->offset = 0;
+}
+
+size_t StepArena::getBytesUsed() const {
+    size_t used = this->offset;
+    for (size_t i = 0; i < this->block && i < this->blocks.size(); i ++) {
+        used += this->blocks[i].size;
+    }
+    return used;
+}
+
+size_t StepArena::getCapacity() const {
+    size_t capacity = 0;
+    for (const Block& block : this->blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
@@ -0,0 +1,115 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_ARENA_H
+#define F1_STRATEGIES_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/* ARENA MACROS */
+#define ARENA_BLOCK_SIZE (1 << 20)
+#define ARENA_ALIGNMENT 16
+
+/*
+ * Bump allocator for the temporaries of a training step. While a StepArena::Scope is active on a thread, the
+ * matrices created on that thread take their memory from the arena, freeing them costs nothing and the arena
+ * is reset when the scope ends. The blocks are kept across resets, so once the first steps have grown the arena
+ * to the size of a step, training doesn't touch the heap for its matrices anymore.
+ *
+ * Every matrix remembers where its memory comes from: assigning an arena matrix to one that lives on the heap
+ * (the weights, the optimizer caches, ...) copies the values instead of handing over the arena memory, so
+ * nothing outlives the reset. Move construction is the exception: the new matrix takes the arena memory with it,
+ * so a matrix built inside a Scope must not be move-constructed into anything that outlives the Scope (a member,
+ * a container kept after the step, a return value past the scope's block); assign it to a heap matrix instead.
+ * */
+class StepArena {
+public:
+    StepArena() = default;
+    ~StepArena() = default;
+    StepArena(const StepArena&) = delete;
+    StepArena& operator = (const StepArena&) = delete;
+
+    void* allocate(const size_t& bytes);
+    /* every pointer handed out since the last reset becomes invalid */
+    void reset();
+
+    [[nodiscard]] size_t getBytesUsed() const;
+    [[nodiscard]] size_t getCapacity() const;
+
+    /* the arena of the calling thread's innermost scope, null when matrices go to the heap */
+    static StepArena* current() { return StepArena::active; }
+
+    /* heap allocations made for matrices, arena blocks included, across every thread */
+    static size_t getHeapAllocations() { return StepArena::heapAllocations.load(std::memory_order_relaxed); }
+    static void countHeapAllocation() { StepArena::heapAllocations.fetch_add(1, std::memory_order_relaxed); }
+
+    /* makes the arena current on this thread and resets it when it ends */
+    class Scope {
+    public:
+        explicit Scope(StepArena& arena) : arena(arena), previous(StepArena::active) { StepArena::active = &arena; }
+        ~Scope() { StepArena::active = this->previous; this->arena.reset(); }
+        Scope(const Scope&) = delete;
+        Scope& operator = (const Scope&) = delete;
+    private:
+        StepArena& arena;
+        StepArena* previous;
+    };
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t block = 0;       // block being filled
+    size_t offset = 0;      // in that block
+
+    static thread_local StepArena* active;
+    static std::atomic<size_t> heapAllocations;
+};
+
+/*
+ * Allocator of the matrix rows. It is bound to the arena that was current when it was created (or to the heap),
+ * and containers don't carry it over on assignment, which is what keeps the heap matrices on the heap.
+ * */
+template <typename T>
+class StepAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+    using is_always_equal = std::false_type;
+
+    StepAllocator() noexcept : arena(StepArena::current()) {}
+    template <typename U>
+    StepAllocator(const StepAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(const size_t n) {
+        if (this->arena) return static_cast<T*>(this->arena->allocate(n * sizeof(T)));
+        StepArena::countHeapAllocation();
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* pointer, const size_t n) noexcept {
+        if (!this->arena) std::allocator<T>().deallocate(pointer, n);
+    }
+
+    /* copies go wherever the copying thread allocates */
+    StepAllocator select_on_container_copy_construction() const { return StepAllocator(); }
+
+    template <typename U>
+    bool operator == (const StepAllocator<U>& other) const noexcept { return this->arena == other.arena; }
+
+private:
+    template <typename U> friend class StepAllocator;
+    StepArena* arena;
+};
+
+#endif //F1_STRATEGIES_ARENA_H
@@ -0,0 +1,210 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "checkpoint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+/* Utility functions */
+namespace {
+
+    template <typename T>
+    void writeValue(std::ostream& o, const T& value) {
+        o.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeMatrix(std::ostream& o, const Matrix& matrix) {
+        writeValue<uint64_t>(o, matrix.getRowSize());
+        writeValue<uint64_t>(o, matrix.getColumnSize());
+        for (size_t i = 0; i < matrix.getRowSize(); i ++) {
+            for (size_t j = 0; j < matrix.getColumnSize(); j ++) {
+                writeValue<double>(o, matrix(i, j));
+            }
+        }
+    }
+
+    void writeMatrices(std::ostream& o, const std::vector<Matrix>& matrices) {
+        writeValue<uint64_t>(o, matrices.size());
+        for (const Matrix& matrix : matrices) {
+            writeMatrix(o, matrix);
+        }
+    }
+
+    /* reads from a file of known size, so corrupted counts fail instead of allocating whatever they say */
+    class CheckpointReader {
+    public:
+        CheckpointReader(std::istream& in, const uint64_t& size) : in(in), remaining(size) {}
+
+        template <typename T>
+        T value() {
+            this->consume(sizeof(T));
+            T value;
+            this->in.read(reinterpret_cast<char*>(&value), sizeof(T));
+            if (!this->in) throw std::runtime_error("The checkpoint is truncated!");
+            return value;
+        }
+
+        /* a count of items taking at least itemSize bytes each */
+        uint64_t count(const uint64_t& itemSize) {
+            const auto count = this->value<uint64_t>();
+            if (itemSize && count > this->remaining / itemSize) throw std::runtime_error("The checkpoint is corrupted!");
+            return count;
+        }
+
+        Matrix matrix() {
+            const auto rows = this->count(sizeof(uint64_t));
+            const auto columns = this->value<uint64_t>();
+            if (!rows || !columns) return {};
+            if (columns > this->remaining / sizeof(double) / rows) throw std::runtime_error("The checkpoint is corrupted!");
+            Matrix::Rows data = Matrix::allocateRows(rows, columns);
+            for (Matrix::Row& row : data) {
+                for (double& value : row) {
+                    value = this->value<double>();
+                }
+            }
+            return Matrix(std::move(data));
+        }
+
+        std::vector<Matrix> matrices() {
+            std::vector<Matrix> matrices(this->count(2 * sizeof(uint64_t)));
+            for (Matrix& matrix : matrices) {
+                matrix = this->matrix();
+            }
+            return matrices;
+        }
+
+        std::string string() {
+            std::string string(this->count(1), '\0');
+            this->consume(string.size());
+            this->in.read(string.data(), (std::streamsize)string.size());
+            if (!this->in) throw std::runtime_error("The checkpoint is truncated!");
+            return string;
+        }
+
+        [[nodiscard]] uint64_t getRemaining() const { return this->remaining; }
+
+    private:
+        void consume(const uint64_t& bytes) {
+            if (bytes > this->remaining) throw std::runtime_error("The checkpoint is truncated!");
+            this->remaining -= bytes;
+        }
+
+        std::istream& in;
+        uint64_t remaining;
+    };
+
+}
+
+/* Checkpoint */
+
+void Checkpoint::write(const std::string &path) const {
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Unable to open file!" << std::endl;
+            return;
+        }
+        file.write(CHECKPOINT_MAGIC, (std::streamsize)std::strlen(CHECKPOINT_MAGIC));
+        writeValue<uint32_t>(file, CHECKPOINT_VERSION);
+        writeValue<int32_t>(file, this->epoch);
+        writeMatrices(file, this->parameters);
+        writeValue<uint64_t>(file, this->optimizers.size());
+        for (const OptimizerState& optimizer : this->optimizers) {
+            writeValue<int64_t>(file, optimizer.step);
+            writeMatrices(file, optimizer.caches);
+        }
+        writeValue<uint64_t>(file, this->randomState.size());
+        file.write(this->randomState.data(), (std::streamsize)this->randomState.size());
+        writeValue<double>(file, this->validation.bestLoss);
+        writeValue<int32_t>(file, this->validation.bestEpoch);
+        writeValue<uint64_t>(file, this->validation.checksWithoutImprovement);
+        writeMatrices(file, this->validation.bestParameters);
+        file.flush();
+        if (!file) throw std::runtime_error("Failed to write the checkpoint " + temporaryPath);
+    }
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("Failed to move the checkpoint to " + path);
+}
+
+Checkpoint Checkpoint::read(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) throw std::invalid_argument("File not found");
+    const auto size = (uint64_t)file.tellg();
+    file.seekg(0);
+    CheckpointReader reader(file, size);
+
+    std::string magic(std::strlen(CHECKPOINT_MAGIC), '\0');
+    for (char& c : magic) {
+        c = reader.value<char>();
+    }
+    if (magic != CHECKPOINT_MAGIC) throw std::runtime_error(path + " isn't a checkpoint!");
+    if (reader.value<uint32_t>() != CHECKPOINT_VERSION) throw std::runtime_error(path + " was written by another version!");
+
+    Checkpoint checkpoint;
+    checkpoint.epoch = reader.value<int32_t>();
+    checkpoint.parameters = reader.matrices();
+    checkpoint.optimizers.resize(reader.count(sizeof(int64_t) + sizeof(uint64_t)));
+    for (OptimizerState& optimizer : checkpoint.optimizers) {
+        optimizer.step = reader.value<int64_t>();
+        optimizer.caches = reader.matrices();
+    }
+    checkpoint.randomState = reader.string();
+    checkpoint.validation.bestLoss = reader.value<double>();
+    checkpoint.validation.bestEpoch = reader.value<int32_t>();
+    checkpoint.validation.checksWithoutImprovement = reader.value<uint64_t>();
+    checkpoint.validation.bestParameters = reader.matrices();
+    if (reader.getRemaining()) throw std::runtime_error(path + " holds more than a checkpoint!");
+    return checkpoint;
+}
+
+/* Checkpoint writer */
+
+CheckpointWriter::CheckpointWriter() : thread(&CheckpointWriter::run, this) {}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->condition.notify_all();
+    this->thread.join();
+}
+
+void CheckpointWriter::submit(const std::string &path, Checkpoint checkpoint) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->pending.emplace(path, std::move(checkpoint));
+    }
+    this->condition.notify_all();
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->condition.wait(lock, [this]() { return !this->pending && !this->writing; });
+}
+
+void CheckpointWriter::run() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (true) {
+        this->condition.wait(lock, [this]() { return this->pending || this->stopping; });
+        if (!this->pending) return;
+        std::pair<std::string, Checkpoint> checkpoint = std::move(*this->pending);
+        this->pending.reset();
+        this->writing = true;
+        lock.unlock();
+        try {
+            checkpoint.second.write(checkpoint.first);
+        } catch (const std::exception& e) {
+            // training goes on, the previous checkpoint is still there
+            std::cerr << e.what() << std::endl;
+        }
+        lock.lock();
+        this->writing = false;
+        this->condition.notify_all();
+    }
+}
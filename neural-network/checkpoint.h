@@ -0,0 +1,78 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_CHECKPOINT_H
+#define F1_STRATEGIES_CHECKPOINT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "matrix.h"
+#include "optimizers.h"
+
+/* CHECKPOINT MACROS */
+#define CHECKPOINT_MAGIC "F1CKPT"
+#define CHECKPOINT_VERSION 1
+
+/* where the early stopping of a training stands, see EarlyStopping */
+struct ValidationProgress {
+    double bestLoss = std::numeric_limits<double>::infinity();
+    int bestEpoch = -1;
+    size_t checksWithoutImprovement = 0;
+    std::vector<Matrix> bestParameters;     // only kept when the best parameters are restored at the end
+};
+
+/*
+ * Everything a training needs to carry on where it stopped: the parameters and optimizer state of every layer,
+ * the number of epochs done, the state of the generator shuffling the batches and the early stopping progress.
+ *
+ * The file is binary, in the machine's byte order: the magic and version, the epoch, then every matrix as its
+ * row and column counts followed by its values row by row. It is written next to its path and renamed over it
+ * once complete, so a crash mid-write leaves the previous checkpoint intact.
+ * */
+struct Checkpoint {
+    int epoch = 0;                              // epochs done
+    std::vector<Matrix> parameters;             // see Model::getParameters
+    std::vector<OptimizerState> optimizers;     // one per layer, from the input layer to the output one
+    std::string randomState;                    // the shuffling generator, as its operator << prints it
+    ValidationProgress validation;
+
+    void write(const std::string& path) const;
+    static Checkpoint read(const std::string& path);
+};
+
+/*
+ * Writes checkpoints on a background thread so training doesn't wait on the disk. Only the latest checkpoint
+ * matters: one submitted while another is still waiting for the thread replaces it.
+ * */
+class CheckpointWriter {
+public:
+    CheckpointWriter();
+    /* writes what is still pending first */
+    ~CheckpointWriter();
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator = (const CheckpointWriter&) = delete;
+
+    void submit(const std::string& path, Checkpoint checkpoint);
+    /* blocks until every submitted checkpoint is on disk */
+    void flush();
+
+private:
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::optional<std::pair<std::string, Checkpoint>> pending;
+    bool writing = false;
+    bool stopping = false;
+    std::thread thread;
+};
+
+#endif //F1_STRATEGIES_CHECKPOINT_H
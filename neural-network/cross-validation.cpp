@@ -0,0 +1,109 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "cross-validation.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+
+std::vector<Fold> makeFolds(const size_t &sampleCount, const size_t &k, const std::vector<long> &groups, const unsigned &seed) {
+    if (k < 2)
+        throw std::invalid_argument("Cross-validation needs at least 2 folds!");
+    if (!groups.empty() && groups.size() != sampleCount)
+        throw std::invalid_argument("Every sample needs a group!");
+
+    // the samples of every group, in the order of the groups' first sample
+    std::map<long, size_t> groupIndex;
+    std::vector<std::vector<size_t>> members;
+    for (size_t i = 0; i < sampleCount; i ++) {
+        if (groups.empty()) {
+            members.push_back({i});
+            continue;
+        }
+        const auto [it, inserted] = groupIndex.emplace(groups[i], members.size());
+        if (inserted) members.emplace_back();
+        members[it->second].push_back(i);
+    }
+    if (members.size() < k)
+        throw std::invalid_argument("There are fewer groups than folds!");
+
+    std::mt19937 random(seed);
+    std::shuffle(members.begin(), members.end(), random);
+    // ties keep the shuffled order, which spreads groups of the same size at random
+    std::stable_sort(members.begin(), members.end(), [](const std::vector<size_t>& a, const std::vector<size_t>& b) {
+        return a.size() > b.size();
+    });
+    std::vector<Fold> folds(k);
+    for (const std::vector<size_t>& group : members) {
+        Fold& smallest = *std::min_element(folds.begin(), folds.end(), [](const Fold& a, const Fold& b) {
+            return a.validation.size() < b.validation.size();
+        });
+        smallest.validation.insert(smallest.validation.end(), group.begin(), group.end());
+    }
+
+    for (Fold& fold : folds) {
+        std::sort(fold.validation.begin(), fold.validation.end());
+        fold.training.reserve(sampleCount - fold.validation.size());
+        size_t next = 0;
+        for (size_t i = 0; i < sampleCount; i ++) {
+            if (next < fold.validation.size() && fold.validation[next] == i) next ++;
+            else fold.training.push_back(i);
+        }
+    }
+    return folds;
+}
+
+std::vector<long> groupsFromFeature(const std::vector<Matrix> &X, const size_t &feature) {
+    std::map<double, long> ids;
+    std::vector<long> groups;
+    groups.reserve(X.size());
+    for (const Matrix& x : X) {
+        if (feature >= x.getRowSize())
+            throw std::invalid_argument("Feature index out of range");
+        groups.push_back(ids.emplace(x(feature, 0), (long)ids.size()).first->second);
+    }
+    return groups;
+}
+
+void CrossValidationResult::print(std::ostream &o) const {
+    for (size_t f = 0; f < this->folds.size(); f ++) {
+        const FoldResult& fold = this->folds[f];
+        o << "Fold " << f + 1 << " : validation loss " << fold.validationLoss << " (" << fold.trainingSize
+          << " training / " << fold.validationSize << " validation samples)" << std::endl;
+        fold.errors.print(o, "    absolute error, sector");
+    }
+    o << "Cross-validation loss : " << this->meanLoss << " +/- " << this->lossStdDev << std::endl;
+    this->errors.print(o, "Cross-validation absolute error, sector");
+}
+
+CrossValidationResult crossValidate(const TrainingConfiguration &configuration, const int &epochs,
+                                    const std::vector<Matrix> &X, const std::vector<Matrix> &Y,
+                                    const std::vector<Fold> &folds, const size_t &threadCount) {
+    if (X.empty() || X.size() != Y.size())
+        throw std::invalid_argument("Cross-validation needs samples and their targets!");
+    CrossValidationResult result;
+    result.folds.resize(folds.size());
+    parallelFor(folds.size(), threadCount, [&](const size_t& f) {
+        std::unique_ptr<Model> model = configuration.build(X[0].getRowSize(), Y[0].getRowSize());
+        model->setVerbose(false);
+        model->trainNetwork(X, Y, folds[f].training, epochs, configuration.batchSize);
+        FoldResult& fold = result.folds[f];
+        fold.trainingSize = folds[f].training.size();
+        fold.validationSize = folds[f].validation.size();
+        fold.validationLoss = model->evaluateLoss(X, Y, folds[f].validation, &fold.errors);
+    });
+
+    for (const FoldResult& fold : result.folds) {
+        result.meanLoss += fold.validationLoss / (double)result.folds.size();
+        result.errors.merge(fold.errors);
+    }
+    for (const FoldResult& fold : result.folds) {
+        result.lossStdDev += (fold.validationLoss - result.meanLoss) * (fold.validationLoss - result.meanLoss);
+    }
+    result.lossStdDev = std::sqrt(result.lossStdDev / (double)result.folds.size());
+    return result;
+}
@@ -0,0 +1,56 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_CROSS_VALIDATION_H
+#define F1_STRATEGIES_CROSS_VALIDATION_H
+
+#include <ostream>
+#include <vector>
+
+#include "model.h"
+#include "error-histogram.h"
+#include "hyperparameter-search.h"
+
+/* the indices of the samples a fold trains on and of those it is measured on */
+struct Fold {
+    std::vector<size_t> training;
+    std::vector<size_t> validation;
+};
+
+/*
+ * k folds over sampleCount samples. Samples of the same group always land in the same fold, so a driver or a
+ * session seen in training is never used to validate; with no groups every sample is its own group. Groups are
+ * shuffled with the seed, then dealt out largest first to the fold holding the fewest samples, which keeps the
+ * folds about the same size.
+ * */
+std::vector<Fold> makeFolds(const size_t& sampleCount, const size_t& k, const std::vector<long>& groups, const unsigned& seed);
+
+/* a group per sample, the distinct values the samples take at one of their input rows (e.g. FEATURE_DRIVER) */
+std::vector<long> groupsFromFeature(const std::vector<Matrix>& X, const size_t& feature);
+
+struct FoldResult {
+    size_t trainingSize = 0;
+    size_t validationSize = 0;
+    double validationLoss = 0.;
+    ErrorMetrics errors;            // absolute error of every output on the fold's validation samples
+};
+
+struct CrossValidationResult {
+    std::vector<FoldResult> folds;
+    double meanLoss = 0.;
+    double lossStdDev = 0.;
+    ErrorMetrics errors;            // the folds' errors merged, every sample validated exactly once
+
+    void print(std::ostream& o) const;
+};
+
+/*
+ * Trains one model of the configuration per fold, up to threadCount of them at a time (0 for one per core).
+ * Every model reads the shared dataset through its fold's indices, nothing is copied.
+ * */
+CrossValidationResult crossValidate(const TrainingConfiguration& configuration, const int& epochs,
+                                    const std::vector<Matrix>& X, const std::vector<Matrix>& Y,
+                                    const std::vector<Fold>& folds, const size_t& threadCount = 0);
+
+#endif //F1_STRATEGIES_CROSS_VALIDATION_H
@@ -0,0 +1,105 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "ensemble.h"
+
+#include <sstream>
+
+/* Utility functions */
+namespace {
+
+    std::string describe(const ActivationFunction& activation) {
+        std::ostringstream oss;
+        oss << activation;
+        return oss.str();
+    }
+
+}
+
+std::unique_ptr<Ensemble> Ensemble::importModels(const std::vector<std::string> &filePaths) {
+    std::vector<std::unique_ptr<Model>> members;
+    for (const std::string& filePath : filePaths) {
+        members.push_back(Model::importModel(filePath));
+    }
+    return std::make_unique<Ensemble>(members);
+}
+
+Ensemble::Ensemble(const std::vector<std::unique_ptr<Model>> &members) : memberCount(members.size()) {
+    if (members.empty())
+        throw std::invalid_argument("An ensemble needs at least one model!");
+
+    std::vector<std::shared_ptr<Layer>> memberLayers;
+    for (const std::unique_ptr<Model>& member : members) {
+        memberLayers.push_back(member->getInputLayer());
+    }
+    this->inputCount = memberLayers[0]->getWeight().getColumnSize();
+    while (memberLayers[0]) {
+        const Matrix firstWeights = memberLayers[0]->getWeight();
+        const size_t neurons = firstWeights.getRowSize(), activations = firstWeights.getColumnSize();
+        const std::string activation = describe(*memberLayers[0]->getActivation());
+
+        Matrix::Rows weights = Matrix::allocateRows(this->memberCount * neurons, activations);
+        Matrix::Rows biases = Matrix::allocateRows(this->memberCount * neurons, 1);
+        for (size_t m = 0; m < this->memberCount; m ++) {
+            const std::shared_ptr<Layer>& layer = memberLayers[m];
+            if (!layer || layer->getWeight().getRowSize() != neurons || layer->getWeight().getColumnSize() != activations
+                    || describe(*layer->getActivation()) != activation)
+                throw std::invalid_argument("The models of an ensemble must share the same layers and activations!");
+            const Matrix memberWeights = layer->getWeight();
+            const Matrix memberBiases = layer->getBiases();
+            for (size_t i = 0; i < neurons; i ++) {
+                for (size_t k = 0; k < activations; k ++) {
+                    weights[m * neurons + i][k] = memberWeights(i, k);
+                }
+                biases[m * neurons + i][0] = memberBiases(i, 0);
+            }
+        }
+        this->layers.push_back({Matrix(std::move(weights)), Matrix(std::move(biases)), memberLayers[0]->getActivation()->clone()});
+        this->outputCount = neurons;
+
+        for (std::shared_ptr<Layer>& layer : memberLayers) {
+            layer = layer->getNextLayer();
+        }
+    }
+    for (const std::shared_ptr<Layer>& layer : memberLayers) {
+        if (layer)
+            throw std::invalid_argument("The models of an ensemble must share the same layers and activations!");
+    }
+}
+
+Matrix Ensemble::predictMembers(const Matrix &inputs) const {
+    if (inputs.getRowSize() != this->inputCount)
+        throw std::invalid_argument("Inputs must have the ensemble's input size!");
+
+    Matrix activations = inputs;
+    for (size_t l = 0; l < this->layers.size(); l ++) {
+        const StackedLayer& layer = this->layers[l];
+        // every member reads the same inputs, a single block, then only the outputs of its own previous layer
+        Matrix weightedInput = layer.weights.blockMultiply(activations, l == 0 ? 1 : this->memberCount);
+        weightedInput += layer.biases.broadcastColumns(weightedInput.getColumnSize());
+        activations = layer.activation->function(weightedInput);
+    }
+    return activations;
+}
+
+EnsemblePrediction Ensemble::predict(const Matrix &inputs) const {
+    const Matrix outputs = this->predictMembers(inputs);
+    const size_t samples = outputs.getColumnSize();
+    Matrix::Rows mean = Matrix::allocateRows(this->outputCount, samples);
+    Matrix::Rows variance = Matrix::allocateRows(this->outputCount, samples);
+    for (size_t i = 0; i < this->outputCount; i ++) {
+        for (size_t j = 0; j < samples; j ++) {
+            for (size_t m = 0; m < this->memberCount; m ++) {
+                mean[i][j] += outputs(m * this->outputCount + i, j);
+            }
+            mean[i][j] /= (double)this->memberCount;
+            for (size_t m = 0; m < this->memberCount; m ++) {
+                const double deviation = outputs(m * this->outputCount + i, j) - mean[i][j];
+                variance[i][j] += deviation * deviation;
+            }
+            variance[i][j] /= (double)this->memberCount;
+        }
+    }
+    return {Matrix(std::move(mean)), Matrix(std::move(variance))};
+}
@@ -0,0 +1,56 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_ENSEMBLE_H
+#define F1_STRATEGIES_ENSEMBLE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model.h"
+
+struct EnsemblePrediction {
+    Matrix mean;            // outputs x samples, the members' mean
+    Matrix variance;        // outputs x samples, spread of the members around the mean (divided by the member count)
+};
+
+/*
+ * N models of the same topology evaluated as one, for inference only. The weights of every layer are stacked
+ * member after member: the input layer becomes one (N x neurons) x inputs matrix multiplied with the shared
+ * input batch, the later layers are multiplied block by block in a single pass (Matrix::blockMultiply), so a
+ * forward pass costs one product per layer whatever N is and yields every member's output at once. The members'
+ * weights are copied when the ensemble is built, training them afterwards doesn't change it.
+ * */
+class Ensemble {
+public:
+    /* the models saved under each name, see Model::save */
+    static std::unique_ptr<Ensemble> importModels(const std::vector<std::string>& filePaths);
+
+    explicit Ensemble(const std::vector<std::unique_ptr<Model>>& members);
+    ~Ensemble() = default;
+
+    /* one sample per column */
+    EnsemblePrediction predict(const Matrix& inputs) const;
+
+    /* the outputs of every member, member m in rows [m x outputs, (m + 1) x outputs) */
+    Matrix predictMembers(const Matrix& inputs) const;
+
+    [[nodiscard]] size_t getMemberCount() const { return this->memberCount; }
+    [[nodiscard]] size_t getOutputCount() const { return this->outputCount; }
+
+private:
+    struct StackedLayer {
+        Matrix weights;     // the members' weights on top of each other, (N x neurons) x inputs
+        Matrix biases;      // (N x neurons) x 1
+        std::shared_ptr<ActivationFunction> activation;
+    };
+
+    size_t memberCount;
+    size_t inputCount;
+    size_t outputCount;
+    std::vector<StackedLayer> layers;
+};
+
+#endif //F1_STRATEGIES_ENSEMBLE_H
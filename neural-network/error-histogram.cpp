@@ -0,0 +1,135 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "error-histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/* Utility functions */
+namespace {
+
+    // a value and the midpoint of its bucket are within the precision of each other
+    const double bucketGrowth = (1. + ERROR_HISTOGRAM_PRECISION) / (1. - ERROR_HISTOGRAM_PRECISION);
+    const double logBucketGrowth = std::log(bucketGrowth);
+
+}
+
+/* Error histogram */
+
+ErrorHistogram::ErrorHistogram() : buckets(ErrorHistogram::bucketCount(), 0) {}
+
+size_t ErrorHistogram::bucketCount() {
+    return (size_t)std::ceil(std::log(ERROR_HISTOGRAM_HIGHEST / ERROR_HISTOGRAM_LOWEST) / logBucketGrowth) + 1;
+}
+
+size_t ErrorHistogram::bucket(const double &value) const {
+    if (!(value > ERROR_HISTOGRAM_LOWEST)) return 0;
+    const double index = std::floor(std::log(value / ERROR_HISTOGRAM_LOWEST) / logBucketGrowth);
+    return std::min((size_t)index, this->buckets.size() - 1);
+}
+
+void ErrorHistogram::add(const double &value) {
+    if (!std::isfinite(value)) {
+        this->nonFiniteCount ++;
+        return;
+    }
+    if (value < 0.)
+        throw std::invalid_argument("Error histograms only hold non-negative values!");
+    this->buckets[this->bucket(value)] ++;
+    this->min = this->count ? std::min(this->min, value) : value;
+    this->max = this->count ? std::max(this->max, value) : value;
+    this->count ++;
+    this->sum += value;
+}
+
+void ErrorHistogram::merge(const ErrorHistogram &other) {
+    this->nonFiniteCount += other.nonFiniteCount;
+    if (!other.count) return;
+    for (size_t i = 0; i < this->buckets.size(); i ++) {
+        this->buckets[i] += other.buckets[i];
+    }
+    this->min = this->count ? std::min(this->min, other.min) : other.min;
+    this->max = this->count ? std::max(this->max, other.max) : other.max;
+    this->count += other.count;
+    this->sum += other.sum;
+}
+
+void ErrorHistogram::reset() {
+    std::fill(this->buckets.begin(), this->buckets.end(), 0);
+    this->count = 0;
+    this->nonFiniteCount = 0;
+    this->sum = 0.;
+    this->min = 0.;
+    this->max = 0.;
+}
+
+double ErrorHistogram::quantile(const double &q) const {
+    if (!this->count) return 0.;
+    const uint64_t rank = std::clamp<uint64_t>((uint64_t)std::ceil(std::clamp(q, 0., 1.) * (double)this->count), 1, this->count);
+    uint64_t seen = 0;
+    size_t i = 0;
+    for (; i < this->buckets.size(); i ++) {
+        seen += this->buckets[i];
+        if (seen >= rank) break;
+    }
+    // the first and last buckets are open-ended, the exact extremes are the best guess there
+    if (i == 0) return this->min;
+    if (i == this->buckets.size() - 1) return this->max;
+    const double midpoint = 2. * ERROR_HISTOGRAM_LOWEST * std::pow(bucketGrowth, (double)i + 1.) / (bucketGrowth + 1.);
+    return std::clamp(midpoint, this->min, this->max);
+}
+
+/* Error metrics */
+
+void ErrorMetrics::add(const Matrix &target, const Matrix &prediction) {
+    if (target.getRowSize() != prediction.getRowSize() || target.getColumnSize() != prediction.getColumnSize())
+        throw std::invalid_argument("The targets and the predictions must be of the same size!");
+    this->resize(prediction.getRowSize());
+    for (size_t i = 0; i < prediction.getRowSize(); i ++) {
+        for (size_t j = 0; j < prediction.getColumnSize(); j ++) {
+            this->outputs[i].add(std::abs(target(i, j) - prediction(i, j)));
+        }
+    }
+}
+
+void ErrorMetrics::add(const Matrix &target, const Matrix &prediction, const size_t &column) {
+    if (target.getRowSize() != prediction.getRowSize() || column >= prediction.getColumnSize())
+        throw std::invalid_argument("The target doesn't match the prediction's column!");
+    this->resize(prediction.getRowSize());
+    for (size_t i = 0; i < prediction.getRowSize(); i ++) {
+        this->outputs[i].add(std::abs(target(i, 0) - prediction(i, column)));
+    }
+}
+
+void ErrorMetrics::merge(const ErrorMetrics &other) {
+    if (other.outputs.empty()) return;
+    this->resize(other.outputs.size());
+    for (size_t i = 0; i < this->outputs.size(); i ++) {
+        this->outputs[i].merge(other.outputs[i]);
+    }
+}
+
+void ErrorMetrics::reset() {
+    for (ErrorHistogram& histogram : this->outputs) {
+        histogram.reset();
+    }
+}
+
+void ErrorMetrics::print(std::ostream &o, const std::string &prefix, const double &scale) const {
+    for (size_t i = 0; i < this->outputs.size(); i ++) {
+        const ErrorHistogram& histogram = this->outputs[i];
+        o << prefix << " " << i + 1 << " : p50 " << histogram.quantile(0.5) * scale << " | p90 " << histogram.quantile(0.9) * scale
+          << " | p99 " << histogram.quantile(0.99) * scale << " | max " << histogram.getMax() * scale;
+        if (histogram.getNonFiniteCount()) o << " | non-finite " << histogram.getNonFiniteCount();
+        o << std::endl;
+    }
+}
+
+void ErrorMetrics::resize(const size_t &outputCount) {
+    if (this->outputs.empty()) this->outputs.resize(outputCount);
+    else if (this->outputs.size() != outputCount)
+        throw std::invalid_argument("Every prediction must hold the same number of outputs!");
+}
@@ -0,0 +1,86 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_ERROR_HISTOGRAM_H
+#define F1_STRATEGIES_ERROR_HISTOGRAM_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "matrix.h"
+
+/* ERROR HISTOGRAM MACROS */
+#define ERROR_HISTOGRAM_PRECISION 0.01        // relative error of the reported quantiles
+#define ERROR_HISTOGRAM_LOWEST 1e-6           // smaller values share the first bucket
+#define ERROR_HISTOGRAM_HIGHEST 1e6           // larger values share the last bucket
+
+/*
+ * Streaming histogram of non-negative values with logarithmic buckets: bucket i holds the values in
+ * [lowest * growth^i, lowest * growth^(i + 1)), with the growth chosen so any value in a bucket is within the
+ * precision of its midpoint. Its memory doesn't depend on the number of values, and two histograms merge by
+ * adding their counts, so every thread can fill its own and they're combined at the end. NaN and infinite values,
+ * e.g. the errors of a diverged training, are only counted apart and left out of the quantiles.
+ * */
+class ErrorHistogram {
+public:
+    ErrorHistogram();
+
+    void add(const double& value);
+    void merge(const ErrorHistogram& other);
+    void reset();
+
+    /* nearest-rank quantile, q in [0, 1], 0 when the histogram is empty */
+    [[nodiscard]] double quantile(const double& q) const;
+
+    /* finite values only */
+    [[nodiscard]] uint64_t getCount() const { return this->count; }
+    [[nodiscard]] uint64_t getNonFiniteCount() const { return this->nonFiniteCount; }
+    [[nodiscard]] double getMean() const { return this->count ? this->sum / (double)this->count : 0.; }
+    [[nodiscard]] double getMin() const { return this->count ? this->min : 0.; }
+    [[nodiscard]] double getMax() const { return this->count ? this->max : 0.; }
+
+private:
+    static size_t bucketCount();
+    [[nodiscard]] size_t bucket(const double& value) const;
+
+    std::vector<uint64_t> buckets;
+    uint64_t count = 0;
+    uint64_t nonFiniteCount = 0;
+    double sum = 0.;
+    double min = 0.;
+    double max = 0.;
+};
+
+/*
+ * One ErrorHistogram per model output, fed the absolute errors of whole predictions. Sized on the first
+ * prediction it sees.
+ * */
+class ErrorMetrics {
+public:
+    ErrorMetrics() = default;
+
+    /* target and prediction hold one sample per column */
+    void add(const Matrix& target, const Matrix& prediction);
+    /* the prediction's column of the sample, against a single-sample target */
+    void add(const Matrix& target, const Matrix& prediction, const size_t& column);
+    void merge(const ErrorMetrics& other);
+    /* empties the histograms, keeping their memory */
+    void reset();
+
+    [[nodiscard]] size_t getOutputCount() const { return this->outputs.size(); }
+    [[nodiscard]] const ErrorHistogram& getOutput(const size_t& output) const { return this->outputs.at(output); }
+
+    /* one "<prefix> k : p50 .. | p90 .. | p99 .. | max .." line per output, the values scaled by scale, followed by
+       "| non-finite n" when some errors were NaN or infinite */
+    void print(std::ostream& o, const std::string& prefix, const double& scale = 1.) const;
+
+private:
+    void resize(const size_t& outputCount);
+
+    std::vector<ErrorHistogram> outputs;
+};
+
+#endif //F1_STRATEGIES_ERROR_HISTOGRAM_H
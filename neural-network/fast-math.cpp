@@ -0,0 +1,85 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "fast-math.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+/* 4-lane version of fastMath::exp, same reduction and polynomial */
+inline __m256d exp4(__m256d x) {
+    x = _mm256_max_pd(_mm256_min_pd(x, _mm256_set1_pd(FAST_EXP_LIMIT)), _mm256_set1_pd(-FAST_EXP_LIMIT));
+    const __m256d n = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(fastMath::LOG2E)), _mm256_set1_pd(0.5)));
+    const __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(fastMath::LN2_HI))),
+                                    _mm256_mul_pd(n, _mm256_set1_pd(fastMath::LN2_LO)));
+    __m256d p = _mm256_set1_pd(1. / 5040.);
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1. / 720.));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1. / 120.));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1. / 24.));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1. / 6.));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(0.5));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.));
+    // n + 1023 lands in the low mantissa bits once 2^52 is added, shifting it by 52 makes it the exponent of 2^n
+    const __m256i bits = _mm256_slli_epi64(_mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(4503599627370496. + 1023.))), 52);
+    return _mm256_mul_pd(p, _mm256_castsi256_pd(bits));
+}
+#endif
+
+void fastMath::exp(const double* input, double* output, const size_t& size) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= size; i += 4) {
+        _mm256_storeu_pd(output + i, exp4(_mm256_loadu_pd(input + i)));
+    }
+#endif
+    for (; i < size; i ++) {
+        output[i] = fastMath::exp(input[i]);
+    }
+}
+
+void fastMath::tanh(const double* input, double* output, const size_t& size) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256d one = _mm256_set1_pd(1.);
+    for (; i + 4 <= size; i += 4) {
+        __m256d x = _mm256_loadu_pd(input + i);
+        x = _mm256_max_pd(_mm256_min_pd(x, _mm256_set1_pd(FAST_TANH_LIMIT)), _mm256_set1_pd(-FAST_TANH_LIMIT));
+        const __m256d e = exp4(_mm256_add_pd(x, x));
+        _mm256_storeu_pd(output + i, _mm256_div_pd(_mm256_sub_pd(e, one), _mm256_add_pd(e, one)));
+    }
+#endif
+    for (; i < size; i ++) {
+        output[i] = fastMath::tanh(input[i]);
+    }
+}
+
+void fastMath::sigmoid(const double* input, double* output, const size_t& size) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256d one = _mm256_set1_pd(1.);
+    for (; i + 4 <= size; i += 4) {
+        const __m256d e = exp4(_mm256_sub_pd(_mm256_setzero_pd(), _mm256_loadu_pd(input + i)));
+        _mm256_storeu_pd(output + i, _mm256_div_pd(one, _mm256_add_pd(one, e)));
+    }
+#endif
+    for (; i < size; i ++) {
+        output[i] = fastMath::sigmoid(input[i]);
+    }
+}
+
+void fastMath::elu(const double* input, double* output, const size_t& size, const double& alpha) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256d zero = _mm256_setzero_pd();
+    for (; i + 4 <= size; i += 4) {
+        const __m256d x = _mm256_loadu_pd(input + i);
+        const __m256d negative = _mm256_mul_pd(_mm256_set1_pd(alpha), _mm256_sub_pd(exp4(x), _mm256_set1_pd(1.)));
+        _mm256_storeu_pd(output + i, _mm256_blendv_pd(x, negative, _mm256_cmp_pd(x, zero, _CMP_LT_OQ)));
+    }
+#endif
+    for (; i < size; i ++) {
+        output[i] = input[i] >= 0 ? input[i] : alpha * (fastMath::exp(input[i]) - 1);
+    }
+}
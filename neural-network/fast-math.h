@@ -0,0 +1,75 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_FAST_MATH_H
+#define F1_STRATEGIES_FAST_MATH_H
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Branch-free approximations used by the activation functions when they are built with `approximate = true`.
+ *
+ * exp(x) is reduced to 2^n * exp(r) with |r| <= ln(2) / 2 and exp(r) is a degree 7 polynomial, so its relative
+ * error stays under FAST_EXP_MAX_RELATIVE_ERROR for |x| <= FAST_EXP_LIMIT; beyond that the input is clamped so 2^n
+ * never leaves the normal range. tanh and the sigmoid are built on it and their absolute errors stay under the
+ * bounds below over the whole real line, the ELU's is alpha times exp's. The largest errors measured over the
+ * sweeps of test.cpp (2 million points per range) are rounded up into the *_MEASURED_* bounds, which the test
+ * asserts. The batched versions evaluate 4 doubles per AVX2 instruction when the compiler targets AVX2 and fall
+ * back to the scalar functions otherwise.
+ * */
+
+/* FAST MATH MACROS */
+#define FAST_EXP_MAX_RELATIVE_ERROR 1e-8
+#define FAST_TANH_MAX_ABSOLUTE_ERROR 1e-8
+#define FAST_SIGMOID_MAX_ABSOLUTE_ERROR 1e-8
+#define FAST_EXP_MEASURED_RELATIVE_ERROR 7.1e-9     // measured 7.03e-9
+#define FAST_TANH_MEASURED_ABSOLUTE_ERROR 3.5e-9    // measured 3.41e-9
+#define FAST_SIGMOID_MEASURED_ABSOLUTE_ERROR 1.8e-9 // measured 1.71e-9
+#define FAST_TANH_DERIVATIVE_MEASURED_ERROR 2.7e-9  // 1 - tanh^2, measured 2.59e-9
+#define FAST_EXP_LIMIT 708.                 // exp(709) is the largest finite double
+#define FAST_TANH_LIMIT 20.                 // tanh(20) rounds to 1
+
+namespace fastMath {
+
+    constexpr double LOG2E = 1.4426950408889634;
+    constexpr double LN2_HI = 0.693145751953125;
+    constexpr double LN2_LO = 1.42860682030941723212e-6;
+
+    inline double exp(const double& input) {
+        const double x = input < -FAST_EXP_LIMIT ? -FAST_EXP_LIMIT : (input > FAST_EXP_LIMIT ? FAST_EXP_LIMIT : input);
+        const double n = std::floor(x * LOG2E + 0.5);
+        const double r = (x - n * LN2_HI) - n * LN2_LO;
+        double p = 1. / 5040.;
+        p = p * r + 1. / 720.;
+        p = p * r + 1. / 120.;
+        p = p * r + 1. / 24.;
+        p = p * r + 1. / 6.;
+        p = p * r + 0.5;
+        p = p * r + 1.;
+        p = p * r + 1.;
+        return p * std::bit_cast<double>(static_cast<uint64_t>(static_cast<int64_t>(n) + 1023) << 52);
+    }
+
+    inline double tanh(const double& input) {
+        const double x = input < -FAST_TANH_LIMIT ? -FAST_TANH_LIMIT : (input > FAST_TANH_LIMIT ? FAST_TANH_LIMIT : input);
+        const double e = fastMath::exp(2 * x);
+        return (e - 1) / (e + 1);
+    }
+
+    inline double sigmoid(const double& input) {
+        return 1 / (1 + fastMath::exp(-input));
+    }
+
+    /* Batched versions, input and output may be the same buffer */
+    void exp(const double* input, double* output, const size_t& size);
+    void tanh(const double* input, double* output, const size_t& size);
+    void sigmoid(const double* input, double* output, const size_t& size);
+    void elu(const double* input, double* output, const size_t& size, const double& alpha);
+
+}
+
+#endif //F1_STRATEGIES_FAST_MATH_H
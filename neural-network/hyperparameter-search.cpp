@@ -0,0 +1,179 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "hyperparameter-search.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+/* Utility functions */
+namespace {
+
+    double logUniform(std::mt19937& random, const double& min, const double& max) {
+        if (min <= 0. || max < min)
+            throw std::invalid_argument("Log-uniform ranges must be positive and ordered!");
+        return std::exp(std::uniform_real_distribution<double>(std::log(min), std::log(max))(random));
+    }
+
+    template <typename T>
+    const T& pick(std::mt19937& random, const std::vector<T>& values) {
+        return values[std::uniform_int_distribution<size_t>(0, values.size() - 1)(random)];
+    }
+
+    /* a CSV field, quotes doubled */
+    std::string quoted(const std::string& text) {
+        std::string field = "\"";
+        for (const char c : text) {
+            field += c;
+            if (c == '"') field += '"';
+        }
+        return field + "\"";
+    }
+
+    /* diverged trainings rank last */
+    double rankedLoss(const double& loss) {
+        return std::isnan(loss) ? std::numeric_limits<double>::infinity() : loss;
+    }
+
+}
+
+const char* optimizerKindToStr(const OptimizerKind& kind) {
+    switch (kind) {
+        case OptimizerKind::SGD: return "SGD";
+        case OptimizerKind::RMSPROP: return "RMSPROP";
+        case OptimizerKind::ADAM: return "ADAM";
+        case OptimizerKind::ADAGRAD: return "ADAGRAD";
+        case OptimizerKind::ADA_DELTA: return "ADADelta";
+        default: return "unknown";
+    }
+}
+
+std::unique_ptr<Optimizer> makeOptimizer(const OptimizerKind &kind, const double &learningRate) {
+    switch (kind) {
+        case OptimizerKind::SGD: return std::make_unique<NoOptimization>(learningRate);
+        case OptimizerKind::RMSPROP: return std::make_unique<RMSPROP>(learningRate);
+        case OptimizerKind::ADAM: return std::make_unique<ADAM>(learningRate);
+        case OptimizerKind::ADAGRAD: return std::make_unique<ADAGRAD>(learningRate);
+        case OptimizerKind::ADA_DELTA: return std::make_unique<ADADelta>(learningRate);
+        default: throw std::invalid_argument("Unknown optimizer!");
+    }
+}
+
+/* Training configuration */
+
+std::unique_ptr<Model> TrainingConfiguration::build(const size_t &inputs, const size_t &outputs) const {
+    auto model = std::make_unique<Model>(inputs, *this->activation, std::make_unique<MSE>((float)this->lambda));
+    for (const size_t& neurons : this->hiddenLayers) {
+        model->addLayer(*this->activation, neurons);
+    }
+    model->addLayer(*this->activation, outputs);
+    model->selectOptimiser(makeOptimizer(this->optimizer, this->learningRate));
+    return model;
+}
+
+std::string TrainingConfiguration::describe() const {
+    std::ostringstream oss;
+    for (size_t i = 0; i < this->hiddenLayers.size(); i ++) {
+        oss << (i ? "-" : "") << this->hiddenLayers[i];
+    }
+    oss << " | " << *this->activation << " | " << optimizerKindToStr(this->optimizer) << ", learning rate = "
+        << this->learningRate << " | batch " << this->batchSize << " | lambda = " << this->lambda;
+    return oss.str();
+}
+
+/* Hyperparameter search */
+
+HyperparameterSearch::HyperparameterSearch(SearchSpace space, const SearchParameters &parameters) :
+        space(std::move(space)), parameters(parameters) {
+    if (this->space.hiddenLayers.empty() || this->space.activations.empty() || this->space.optimizers.empty() || this->space.batchSizes.empty())
+        throw std::invalid_argument("Every dimension of the search space needs at least one value!");
+    if (parameters.configurationCount == 0 || parameters.minEpochs <= 0 || parameters.maxEpochs < parameters.minEpochs)
+        throw std::invalid_argument("The search needs configurations and 0 < minEpochs <= maxEpochs!");
+    if (parameters.reduction < 2)
+        throw std::invalid_argument("Successive halving needs a reduction factor of at least 2!");
+}
+
+TrainingConfiguration HyperparameterSearch::sample(std::mt19937 &random) const {
+    TrainingConfiguration configuration;
+    configuration.hiddenLayers = pick(random, this->space.hiddenLayers);
+    configuration.activation = pick(random, this->space.activations);
+    configuration.optimizer = pick(random, this->space.optimizers);
+    configuration.batchSize = pick(random, this->space.batchSizes);
+    configuration.learningRate = logUniform(random, this->space.minLearningRate, this->space.maxLearningRate);
+    configuration.lambda = logUniform(random, this->space.minLambda, this->space.maxLambda);
+    return configuration;
+}
+
+std::vector<SearchResult> HyperparameterSearch::run(const std::vector<Matrix> &X, const std::vector<Matrix> &Y,
+                                                    const std::vector<Matrix> &validationX, const std::vector<Matrix> &validationY) {
+    if (X.empty() || X.size() != Y.size() || validationX.empty() || validationX.size() != validationY.size())
+        throw std::invalid_argument("The search needs training and validation samples with their targets!");
+
+    std::mt19937 random(this->parameters.seed);
+    std::vector<SearchResult> results(this->parameters.configurationCount);
+    std::vector<std::unique_ptr<Model>> models(results.size());
+    for (size_t i = 0; i < results.size(); i ++) {
+        results[i].configuration = this->sample(random);
+        models[i] = results[i].configuration.build(X[0].getRowSize(), Y[0].getRowSize());
+        models[i]->setVerbose(false);
+    }
+
+    std::vector<size_t> survivors(results.size());
+    std::iota(survivors.begin(), survivors.end(), 0);
+    int budget = this->parameters.minEpochs;
+    for (int rung = 0; ; rung ++) {
+        parallelFor(survivors.size(), this->parameters.threadCount, [&](const size_t& s) {
+            SearchResult& result = results[survivors[s]];
+            if (!result.failure.empty()) return;
+            Model& model = *models[survivors[s]];
+            try {
+                model.trainNetwork(X, Y, budget - result.epochs, result.configuration.batchSize);
+                result.epochs = budget;
+                result.validationLoss = model.evaluateLoss(validationX, validationY);
+            } catch (const std::exception& e) {
+                result.failure = e.what();
+                result.validationLoss = std::numeric_limits<double>::infinity();
+            }
+        });
+        std::stable_sort(survivors.begin(), survivors.end(), [&results](const size_t& a, const size_t& b) {
+            return rankedLoss(results[a].validationLoss) < rankedLoss(results[b].validationLoss);
+        });
+        std::cout << "Rung " << rung + 1 << " : " << survivors.size() << " configuration(s) at " << budget
+                  << " epochs, best validation loss " << results[survivors[0]].validationLoss << std::endl;
+        if (survivors.size() == 1 || budget >= this->parameters.maxEpochs) break;
+
+        const size_t kept = std::max<size_t>(survivors.size() / this->parameters.reduction, 1);
+        for (size_t s = kept; s < survivors.size(); s ++) {
+            models[survivors[s]].reset();
+        }
+        survivors.resize(kept);
+        budget = (int)std::min<long>((long)budget * (long)this->parameters.reduction, this->parameters.maxEpochs);
+    }
+    this->bestModel = std::move(models[survivors[0]]);
+
+    std::stable_sort(results.begin(), results.end(), [](const SearchResult& a, const SearchResult& b) {
+        if (a.epochs != b.epochs) return a.epochs > b.epochs;
+        return rankedLoss(a.validationLoss) < rankedLoss(b.validationLoss);
+    });
+    return results;
+}
+
+void HyperparameterSearch::writeLeaderboard(std::ostream &o, const std::vector<SearchResult> &leaderboard) {
+    o << "rank,epochs,validation_loss,hidden_layers,activation,optimizer,learning_rate,batch_size,lambda,failure\n";
+    for (size_t i = 0; i < leaderboard.size(); i ++) {
+        const SearchResult& result = leaderboard[i];
+        const TrainingConfiguration& configuration = result.configuration;
+        std::ostringstream layers, activation;
+        for (size_t l = 0; l < configuration.hiddenLayers.size(); l ++) {
+            layers << (l ? "-" : "") << configuration.hiddenLayers[l];
+        }
+        activation << *configuration.activation;
+        o << i + 1 << "," << result.epochs << "," << result.validationLoss << "," << layers.str() << ","
+          << quoted(activation.str()) << "," << optimizerKindToStr(configuration.optimizer) << "," << configuration.learningRate
+          << "," << configuration.batchSize << "," << configuration.lambda << "," << quoted(result.failure) << "\n";
+    }
+}
@@ -0,0 +1,91 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_HYPERPARAMETER_SEARCH_H
+#define F1_STRATEGIES_HYPERPARAMETER_SEARCH_H
+
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "model.h"
+
+enum class OptimizerKind { SGD, RMSPROP, ADAM, ADAGRAD, ADA_DELTA };
+
+const char* optimizerKindToStr(const OptimizerKind& kind);
+std::unique_ptr<Optimizer> makeOptimizer(const OptimizerKind& kind, const double& learningRate);
+
+/* what the search samples from, every list must hold at least one entry */
+struct SearchSpace {
+    std::vector<std::vector<size_t>> hiddenLayers;                  // neuron counts of the hidden layers
+    std::vector<std::shared_ptr<ActivationFunction>> activations;   // of every layer, the output one included
+    std::vector<OptimizerKind> optimizers;
+    std::vector<size_t> batchSizes;
+    double minLearningRate = 1e-4, maxLearningRate = 1e-1;          // sampled log-uniformly
+    double minLambda = 1e-3, maxLambda = 1.;                        // L2 weight of the MSE loss, sampled log-uniformly
+};
+
+struct TrainingConfiguration {
+    std::vector<size_t> hiddenLayers;
+    std::shared_ptr<ActivationFunction> activation;
+    OptimizerKind optimizer = OptimizerKind::SGD;
+    double learningRate = 0.;
+    size_t batchSize = 1;
+    double lambda = 0.;
+
+    [[nodiscard]] std::unique_ptr<Model> build(const size_t& inputs, const size_t& outputs) const;
+    [[nodiscard]] std::string describe() const;
+};
+
+struct SearchParameters {
+    size_t configurationCount = 27;
+    int minEpochs = 4;              // trained by every configuration before the first pruning
+    int maxEpochs = 100;
+    size_t reduction = 3;           // each rung keeps a reduction-th of the configurations, for reduction times the epochs
+    size_t threadCount = 0;         // 0 for one per core
+    unsigned seed = 0;
+};
+
+struct SearchResult {
+    TrainingConfiguration configuration;
+    int epochs = 0;                 // trained before it was pruned or the search ended
+    double validationLoss = std::numeric_limits<double>::infinity();
+    std::string failure;            // what its training threw, empty if it didn't
+};
+
+/*
+ * Random search pruned by successive halving. Every sampled configuration trains for minEpochs, then only the
+ * best reduction-th of them (by validation loss) carries on to reduction times as many epochs, and so on until
+ * one configuration is left or maxEpochs is reached. Surviving models keep training where they stopped.
+ *
+ * The trainings of a rung run concurrently, every model with its own arena and optimizers, and all of them
+ * read the same dataset. A configuration whose training throws (or diverges to a NaN loss) ranks last with an
+ * infinite loss and isn't trained again, the others carry on.
+ * */
+class HyperparameterSearch {
+public:
+    HyperparameterSearch(SearchSpace space, const SearchParameters& parameters);
+
+    /* the leaderboard: the configurations that trained longest first, then by validation loss */
+    std::vector<SearchResult> run(const std::vector<Matrix>& X, const std::vector<Matrix>& Y,
+                                  const std::vector<Matrix>& validationX, const std::vector<Matrix>& validationY);
+
+    /* the model of the leaderboard's first configuration, null until the search ran */
+    std::unique_ptr<Model> takeBestModel() { return std::move(this->bestModel); }
+
+    /* the leaderboard as CSV, one configuration per line */
+    static void writeLeaderboard(std::ostream& o, const std::vector<SearchResult>& leaderboard);
+
+private:
+    TrainingConfiguration sample(std::mt19937& random) const;
+
+    SearchSpace space;
+    SearchParameters parameters;
+    std::unique_ptr<Model> bestModel;
+};
+
+#endif //F1_STRATEGIES_HYPERPARAMETER_SEARCH_H
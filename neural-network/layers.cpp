@@ -13,6 +13,7 @@ Layer::Layer(const ActivationFunction &f, const size_t &neuronCount, const size_
              const int &layerNumber) {
     this->activation = std::move(f.clone());
     this->layerNumber = layerNumber;
+    this->hasNextLayer = false;
     this->neuronCount = neuronCount;
     this->activationCount = activationCount;
     std::vector<std::unique_ptr<std::vector<double>>> delVals(neuronCount);
@@ -41,7 +42,10 @@ void Layer::setMatrixMultiplier(const std::shared_ptr<GPUMatrixMultiplier> &f) {
 }
 
 Matrix Layer::output(const Matrix &input) {
-    return this->activation->function(*this->weights * input + *this->biases);
+    // the input may hold a batch of samples, one per column, which all get the same biases
+    Matrix weightedInput = *this->weights * input;
+    weightedInput += this->biases->broadcastColumns(weightedInput.getColumnSize());
+    return this->activation->function(weightedInput);
 }
 
 Matrix Layer::forwardFeed(const Matrix &input) {
@@ -73,8 +77,13 @@ double Layer::getColumnSumWeights(const size_t& column) const {
 }
 
 Matrix Layer::forwardFeedUntilLayer(const Matrix &input, const int& layerNumber) {
-    if (this->hasNextLayer && this->layerNumber != layerNumber) return this->nextLayer->forwardFeedUntilLayer(this->output(input), layerNumber);
-    else return this->output(input);
+    Matrix output;
+    {
+        ScopedTimer timer(ProfilePhase::FORWARD_FEED, this->layerNumber);
+        output = this->output(input);
+    }
+    if (this->hasNextLayer && this->layerNumber != layerNumber) return this->nextLayer->forwardFeedUntilLayer(output, layerNumber);
+    else return output;
 }
 
 void Layer::setOptimizer(std::unique_ptr<Optimizer> o) {
@@ -88,12 +97,13 @@ void Layer::gradientDescent(const std::vector<Matrix>& inputs) {
     }
 
     while (currentLayer->layerNumber > 0) {
+        ScopedTimer timer(ProfilePhase::GRADIENT_DESCENT, currentLayer->layerNumber);
         Matrix accumulatedGradients = Matrix::nullMatrix(currentLayer->weights->getRowSize(), currentLayer->weights->getColumnSize());
         Matrix accumulatedDels = Matrix::nullMatrix(currentLayer->biases->getRowSize(), 1);
 
         for (const Matrix& input : inputs) {
             const Matrix activations = this->forwardFeedUntilLayer(input, currentLayer->layerNumber - 1);
-            const Matrix dels = currentLayer->delValues->clone();
+            const Matrix& dels = *currentLayer->delValues;
 
             accumulatedGradients += dels * activations.transpose();
             accumulatedDels += dels;
@@ -101,8 +111,11 @@ void Layer::gradientDescent(const std::vector<Matrix>& inputs) {
 
         const auto f = [currentLayer](double x) { return x * -currentLayer->optimizer->getLearningRate(); };
 
-        currentLayer->optimizer->updateWeights(*currentLayer->weights, accumulatedGradients.map(f));
-        currentLayer->optimizer->updateBiases(*currentLayer->biases, accumulatedDels.map(f));
+        {
+            ScopedTimer optimizerTimer(ProfilePhase::OPTIMIZER, currentLayer->layerNumber);
+            currentLayer->optimizer->updateWeights(*currentLayer->weights, accumulatedGradients.map(f));
+            currentLayer->optimizer->updateBiases(*currentLayer->biases, accumulatedDels.map(f));
+        }
 
         currentLayer = currentLayer->previousLayer;
     }
@@ -61,8 +61,8 @@ public:
     size_t getNeuronCount() const { return this->neuronCount; }
 
     void updateDels(const Matrix& newValues) {
-        this->delValues = std::make_unique<Matrix>(newValues);
-        this->delValues->setGPUMatrixMult(this->gpuMatrixMultFunction);
+        // copied into the layer's own matrix, which never lives in a training step's arena
+        *this->delValues = newValues;
     }
 
     double getSumDels() const { return this->delValues->sum(); }
@@ -77,6 +77,9 @@ public:
 
     void setOptimizer(std::unique_ptr<Optimizer> o);
 
+    /* null until the model selects one */
+    Optimizer* getOptimizer() const { return this->optimizer.get(); }
+
     void gradientDescent(const std::vector<Matrix>& inputs);
 
 
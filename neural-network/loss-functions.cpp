@@ -15,6 +15,17 @@ void LossFunction::setWeightsSquaredSum(const std::vector<float>& weights) {
     }
 }
 
+void LossFunction::setWeightsSquaredSum(const Matrix& weights) {
+    // same single precision squares as the vector version, without copying the weights
+    this->squaredSumWeights = 0.;
+    for (size_t i = 0; i < weights.getRowSize(); i ++) {
+        for (size_t j = 0; j < weights.getColumnSize(); j ++) {
+            const auto weight = (float)weights(i, j);
+            this->squaredSumWeights += weight * weight;
+        }
+    }
+}
+
 
 double MSE::loss(const Matrix &predicted, const Matrix &targetY) {
     if (predicted.getColumnSize() != 1 || targetY.getColumnSize() != 1) {
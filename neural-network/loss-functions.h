@@ -21,6 +21,7 @@ public:
     /* L2 regularization method */
     double l2Penalty() const;
     void setWeightsSquaredSum(const std::vector<float>& weights);
+    void setWeightsSquaredSum(const Matrix& weights);
 protected:
     double squaredSumWeights;
     float _lambda;
@@ -0,0 +1,160 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_MATRIX_EXPRESSION_H
+#define F1_STRATEGIES_MATRIX_EXPRESSION_H
+
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+
+class Matrix;
+
+/*
+ * Element-wise matrix arithmetic is lazy: `m * a + g * b` builds a small tree of expression nodes instead
+ * of one temporary Matrix per operator. The tree is only walked when it gets assigned to a Matrix (or reduced
+ * with sum()), in one fused loop that writes straight into the destination. Matrix leaves are kept by
+ * reference, so an expression has to be consumed in the statement that builds it (never hold one in `auto`).
+ * Matrix products are not element-wise and stay eager, see Matrix::operator *.
+ * */
+template <typename E>
+class MatrixExpression {
+public:
+    double operator () (const size_t& row, const size_t& column) const { return this->self()(row, column); }
+    [[nodiscard]] size_t getRowSize() const { return this->self().getRowSize(); }
+    [[nodiscard]] size_t getColumnSize() const { return this->self().getColumnSize(); }
+
+    template <typename F>
+    auto map(F callback) const;
+
+    template <typename O, typename F>
+    auto map(const MatrixExpression<O>& other, F callback) const;
+
+    /* repeats a N x 1 expression over the given number of columns */
+    auto broadcastColumns(const size_t& columns) const;
+
+    double sum() const {
+        if (this->getColumnSize() != 1)
+            throw std::invalid_argument("Can only sum a vector or a N x 1 Matrix!");
+        double sum = 0;
+        for (size_t i = 0; i < this->getRowSize(); i ++) {
+            sum += (*this)(i, 0);
+        }
+        return sum;
+    }
+
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+/* Matrices are held by reference, intermediate nodes are small and held by value */
+template <typename E>
+struct ExpressionOperand { using type = const E; };
+
+template <>
+struct ExpressionOperand<Matrix> { using type = const Matrix&; };
+
+template <typename E, typename F>
+class UnaryExpression : public MatrixExpression<UnaryExpression<E, F>> {
+public:
+    UnaryExpression(const E& operand, F callback) : operand(operand), callback(callback) {}
+
+    double operator () (const size_t& row, const size_t& column) const { return this->callback(this->operand(row, column)); }
+    [[nodiscard]] size_t getRowSize() const { return this->operand.getRowSize(); }
+    [[nodiscard]] size_t getColumnSize() const { return this->operand.getColumnSize(); }
+
+private:
+    typename ExpressionOperand<E>::type operand;
+    F callback;
+};
+
+template <typename L, typename R, typename F>
+class BinaryExpression : public MatrixExpression<BinaryExpression<L, R, F>> {
+public:
+    BinaryExpression(const L& lhs, const R& rhs, F callback, const char* operation) :
+            lhs(lhs), rhs(rhs), callback(callback) {
+        if (lhs.getRowSize() != rhs.getRowSize() || lhs.getColumnSize() != rhs.getColumnSize()) {
+            std::ostringstream oss;
+            oss << "Can't perform the " << operation << " of a " << lhs.getRowSize() << "x" << lhs.getColumnSize()
+                << " matrix with a " << rhs.getRowSize() << "x" << rhs.getColumnSize() << " matrix.";
+            throw std::invalid_argument(oss.str());
+        }
+    }
+
+    double operator () (const size_t& row, const size_t& column) const {
+        return this->callback(this->lhs(row, column), this->rhs(row, column));
+    }
+    [[nodiscard]] size_t getRowSize() const { return this->lhs.getRowSize(); }
+    [[nodiscard]] size_t getColumnSize() const { return this->lhs.getColumnSize(); }
+
+private:
+    typename ExpressionOperand<L>::type lhs;
+    typename ExpressionOperand<R>::type rhs;
+    F callback;
+};
+
+template <typename E>
+class BroadcastExpression : public MatrixExpression<BroadcastExpression<E>> {
+public:
+    BroadcastExpression(const E& operand, const size_t& columns) : operand(operand), columns(columns) {
+        if (operand.getColumnSize() != 1) {
+            std::ostringstream oss;
+            oss << "Can only broadcast a N x 1 matrix, not a " << operand.getRowSize() << "x" << operand.getColumnSize() << " matrix.";
+            throw std::invalid_argument(oss.str());
+        }
+    }
+
+    double operator () (const size_t& row, [[maybe_unused]] const size_t& column) const { return this->operand(row, 0); }
+    [[nodiscard]] size_t getRowSize() const { return this->operand.getRowSize(); }
+    [[nodiscard]] size_t getColumnSize() const { return this->columns; }
+
+private:
+    typename ExpressionOperand<E>::type operand;
+    size_t columns;
+};
+
+struct ScaleBy {
+    double scalar;
+    double operator () (const double& x) const { return x * this->scalar; }
+};
+
+template <typename E>
+template <typename F>
+auto MatrixExpression<E>::map(F callback) const {
+    return UnaryExpression<E, F>(this->self(), callback);
+}
+
+template <typename E>
+template <typename O, typename F>
+auto MatrixExpression<E>::map(const MatrixExpression<O>& other, F callback) const {
+    return BinaryExpression<E, O, F>(this->self(), other.self(), callback, "map");
+}
+
+template <typename E>
+auto MatrixExpression<E>::broadcastColumns(const size_t& columns) const {
+    return BroadcastExpression<E>(this->self(), columns);
+}
+
+/* Operators */
+template <typename L, typename R>
+auto operator + (const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs) {
+    return BinaryExpression<L, R, std::plus<>>(lhs.self(), rhs.self(), std::plus<>(), "addition");
+}
+
+template <typename L, typename R>
+auto operator - (const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs) {
+    return BinaryExpression<L, R, std::minus<>>(lhs.self(), rhs.self(), std::minus<>(), "subtraction");
+}
+
+template <typename E>
+auto operator * (const MatrixExpression<E>& expression, const double& scalar) {
+    return UnaryExpression<E, ScaleBy>(expression.self(), ScaleBy{scalar});
+}
+
+template <typename E>
+auto operator * (const double& scalar, const MatrixExpression<E>& expression) {
+    return UnaryExpression<E, ScaleBy>(expression.self(), ScaleBy{scalar});
+}
+
+#endif //F1_STRATEGIES_MATRIX_EXPRESSION_H
@@ -4,6 +4,8 @@
 
 #include "matrix.h"
 
+#include <algorithm>
+
 
 /* utility function */
 float generateRandomNeg1_1() {
@@ -31,25 +33,17 @@ Matrix Matrix::randomMatrix(const size_t& rows, const size_t& columns) {
 }
 
 Matrix Matrix::nullMatrix(const size_t &rows, const size_t &columns) {
-    std::vector<std::unique_ptr<std::vector<double>>> data(rows);
-    for (int i = 0; i < rows; i++) {
-        data[i] = std::make_unique<std::vector<double>>(columns, 0.);
-    }
-    return Matrix(std::move(data));
+    return Matrix(Matrix::allocateRows(rows, columns));
 }
 
 Matrix Matrix::nullVector(const size_t& size) {
-    std::vector<std::unique_ptr<std::vector<double>>> data(size);
-    for (int i = 0; i < size; i ++) {
-        data[i] = std::make_unique<std::vector<double>>(1, 0);
-    }
-    return Matrix(std::move(data));
+    return Matrix(Matrix::allocateRows(size, 1));
 }
 
 Matrix Matrix::randomVector(const size_t& size) {
-    std::vector<std::unique_ptr<std::vector<double>>> data(size);
-    for (int i = 0; i < size; i ++) {
-        data[i] = std::make_unique<std::vector<double>>(1, generateRandomNeg1_1());
+    Rows data = Matrix::allocateRows(size, 1);
+    for (Row& row : data) {
+        row[0] = generateRandomNeg1_1();
     }
     return Matrix(std::move(data));
 }
@@ -58,98 +52,181 @@ Matrix Matrix::fromVector(const std::vector<float> &result, const size_t &column
     Matrix resultMatrix;
     resultMatrix.rows = rows;
     resultMatrix.columns = columns;
-    resultMatrix.data.resize(rows);
+    resultMatrix.data.reserve(rows);
     for (size_t i = 0; i < rows; ++i) {
-        resultMatrix.data[i] = std::make_unique<std::vector<double>>(result.begin() + i * columns, result.begin() + (i + 1) * columns);
+        resultMatrix.data.emplace_back(result.begin() + i * columns, result.begin() + (i + 1) * columns);
     }
     return resultMatrix;
 }
 
+Matrix Matrix::columnVector(const std::vector<double> &values) {
+    Rows data = Matrix::allocateRows(values.size(), 1);
+    for (size_t i = 0; i < values.size(); i ++) {
+        data[i][0] = values[i];
+    }
+    return Matrix(std::move(data));
+}
+
+Matrix Matrix::fromColumns(const std::vector<std::vector<double>> &columns) {
+    if (columns.empty())
+        throw std::invalid_argument("Can't build a matrix without any column!");
+    Rows data = Matrix::allocateRows(columns[0].size(), columns.size());
+    for (size_t j = 0; j < columns.size(); j ++) {
+        if (columns[j].size() != data.size())
+            throw std::invalid_argument("All columns must be of the same size!");
+        for (size_t i = 0; i < data.size(); i ++) {
+            data[i][j] = columns[j][i];
+        }
+    }
+    return Matrix(std::move(data));
+}
+
+Matrix::Rows Matrix::allocateRows(const size_t &rows, const size_t &columns) {
+    Rows data;
+    data.reserve(rows);
+    for (size_t i = 0; i < rows; i ++) {
+        data.emplace_back(columns, 0.);
+    }
+    return data;
+}
+
 /* Constructor */
-Matrix::Matrix(std::vector<std::unique_ptr<std::vector<double>>> data) {
+Matrix::Matrix(Rows data) {
     if (data.empty()) throw std::invalid_argument("Data shouldn't be empty!");
-    if (data[0]->empty()) throw std::invalid_argument("Columns shouldn't be empty!");
-    this->columns = data[0]->size();
+    if (data[0].empty()) throw std::invalid_argument("Columns shouldn't be empty!");
+    this->columns = data[0].size();
     for (int i = 1; i < (int)data.size(); i ++) {
-        if (data[i]->size() != this->columns)
+        if (data[i].size() != this->columns)
             throw std::invalid_argument("All columns must be of the same size!");
     }
     this->rows = data.size();
     this->data = std::move(data);
+    Profiler::allocated(this->rows * this->columns * sizeof(double));
+}
+
+Matrix::Matrix(const std::vector<std::unique_ptr<std::vector<double>>>& data) {
+    if (data.empty()) throw std::invalid_argument("Data shouldn't be empty!");
+    if (data[0]->empty()) throw std::invalid_argument("Columns shouldn't be empty!");
+    this->columns = data[0]->size();
+    this->data.reserve(data.size());
+    for (const std::unique_ptr<std::vector<double>>& row : data) {
+        if (row->size() != this->columns)
+            throw std::invalid_argument("All columns must be of the same size!");
+        this->data.emplace_back(row->begin(), row->end());
+    }
+    this->rows = data.size();
+    Profiler::allocated(this->rows * this->columns * sizeof(double));
 }
 
 /* Copy constructors */
-Matrix::Matrix(const Matrix &other) {
-    *this = other;
+Matrix::Matrix(const Matrix &other) : rows(other.rows), columns(other.columns), data(other.data) {
+    Profiler::allocated(this->rows * this->columns * sizeof(double));
 }
 
 Matrix& Matrix::operator = (const Matrix &other) {
-    //this->data.reserve(other.rows);
-    this->data = std::vector<std::unique_ptr<std::vector<double>>>(other.rows);
-    for (int i = 0; i < other.rows; i ++) {
-        this->data[i] = std::make_unique<std::vector<double>>(other[i]);
+    if (this == &other) return *this;
+    // the values go into this matrix's memory, which stays where it was allocated (see arena.h)
+    if (this->rows == other.rows && this->columns == other.columns) {
+        for (size_t i = 0; i < this->rows; i ++) {
+            std::copy(other.data[i].begin(), other.data[i].end(), this->data[i].begin());
+        }
+        return *this;
     }
+    Rows data(this->data.get_allocator());
+    data.reserve(other.rows);
+    for (const Row& row : other.data) {
+        data.emplace_back(row.begin(), row.end(), Row::allocator_type(this->data.get_allocator()));
+    }
+    Profiler::allocated(other.rows * other.columns * sizeof(double));
+    this->data = std::move(data);
     this->columns = other.columns;
     this->rows = other.rows;
     return *this;
 }
 
-/* Operators */
-
-Matrix Matrix::operator * (const Matrix &other) const {
-#if USE_GPU
-    return this->multGPU(other);
-#else
-    return this->multCPU(other);
-#endif
+/* Move constructors */
+Matrix::Matrix(Matrix &&other) noexcept : rows(other.rows), columns(other.columns), data(std::move(other.data)),
+                                          gpuMatrixMultiplier(std::move(other.gpuMatrixMultiplier)) {
+    other.columns = 0;
+    other.rows = 0;
 }
 
-Matrix& Matrix::operator *= (const Matrix &other) {
-    *this = *this * other;
+Matrix& Matrix::operator = (Matrix &&other) {
+    // like the copy assignment, the destination keeps its own GPU multiplier, and its memory when the other
+    // matrix's comes from somewhere else
+    if (this->data.get_allocator() != other.data.get_allocator())
+        return *this = static_cast<const Matrix&>(other);
+    this->data = std::move(other.data);
+    this->columns = other.columns;
+    this->rows = other.rows;
+    other.columns = 0;
+    other.rows = 0;
     return *this;
 }
 
-Matrix& Matrix::operator*=(const double& scalar) {
-    *this = *this * scalar;
-    return *this;
-}
+/* Operators */
 
-Matrix Matrix::operator * (const double& scalar) const {
+Matrix Matrix::operator * (const Matrix &other) const {
 #if USE_GPU
-    return this->multGPU(scalar);
+    return this->multGPU(other);
 #else
-    return this->multCPU(scalar);
+    return this->multCPU(other);
 #endif
 }
 
-Matrix Matrix::operator + (const Matrix &other) const {
-#if USE_GPU
-    return this->addGPU(other);
-#else
-    return this->addCPU(other);
-#endif
+Matrix Matrix::blockMultiply(const Matrix &other, const size_t &blocks) const {
+    if (blocks == 0 || this->rows % blocks != 0 || other.rows % blocks != 0 || this->columns != other.rows / blocks) {
+        std::ostringstream oss;
+        oss << "Can't perform the block multiplication of a " << this->rows << "x" << this->columns
+            << " matrix with a " << other.rows << "x" << other.columns << " matrix in " << blocks << " blocks.";
+        throw std::invalid_argument(oss.str());
+    }
+    /*
+     * MATRIX_BLOCK_COLUMNS output columns are accumulated at once in locals the compiler keeps in vector registers,
+     * every sum still runs over k in order like multCPU, so each block matches the product of the separate
+     * matrices to the bit
+     * */
+    const size_t blockRows = this->rows / blocks;
+    Rows newData = Matrix::allocateRows(this->rows, other.columns);
+    for (size_t i = 0; i < this->rows; i ++) {
+        const Row& row = this->data[i];
+        const size_t offset = i / blockRows * this->columns;
+        size_t j = 0;
+        for (; j + MATRIX_BLOCK_COLUMNS <= other.columns; j += MATRIX_BLOCK_COLUMNS) {
+            double sums[MATRIX_BLOCK_COLUMNS] = {};
+            for (size_t k = 0; k < this->columns; k ++) {
+                const double* otherRow = other.data[offset + k].data() + j;
+                for (size_t c = 0; c < MATRIX_BLOCK_COLUMNS; c ++) {
+                    sums[c] += row[k] * otherRow[c];
+                }
+            }
+            std::copy(sums, sums + MATRIX_BLOCK_COLUMNS, newData[i].begin() + (long)j);
+        }
+        for (; j < other.columns; j ++) {
+            for (size_t k = 0; k < this->columns; k ++) {
+                newData[i][j] += row[k] * other.data[offset + k][j];
+            }
+        }
+    }
+    return Matrix(std::move(newData));
 }
 
-Matrix& Matrix::operator += (const Matrix &other) {
-    *this = *this + other;
+Matrix& Matrix::operator *= (const Matrix &other) {
+    *this = *this * other;
     return *this;
 }
 
-Matrix Matrix::operator - (const Matrix &other) const {
-#if USE_GPU
-    return this->subGPU(other);
-#else
-    return this->subCPU(other);
-#endif
-}
-
-Matrix& Matrix::operator -= (const Matrix &other) {
-    *this = *this - other;
+Matrix& Matrix::operator*=(const double& scalar) {
+    for (auto& row : this->data) {
+        for (auto& value : row) {
+            value *= scalar;
+        }
+    }
     return *this;
 }
 
 std::vector<double> Matrix::operator [] (int index) const {
-    return *this->data[index];
+    return {this->data[index].begin(), this->data[index].end()};
 }
 
 /* Class methods */
@@ -162,25 +239,8 @@ Matrix Matrix::transpose() const {
 #endif
 }
 
-Matrix Matrix::map(const std::function<double(double)> &callback) const {
-#if USE_GPU
-    return this->mapGPU(callback);
-#else
-    return this->mapCPU(callback);
-#endif
-}
-
-Matrix Matrix::map(const Matrix& other, const std::function<double(double, double)>& callback) const {
-#if USE_GPU
-    return this->mapGPU(other, callback);
-#else
-    return this->mapCPU(other, callback);
-#endif
-}
-
 Matrix Matrix::clone() const {
-    auto identity = [](double x) { return x; };
-    Matrix result = this->map(identity);
+    Matrix result = *this;
     result.setGPUMatrixMult(this->gpuMatrixMultiplier);
     return result;
 }
@@ -197,9 +257,9 @@ Matrix Matrix::getColumn(size_t columnIndex) const {
     if (columnIndex >= columns) {
         throw std::out_of_range("Column index out of range");
     }
-    std::vector<std::unique_ptr<std::vector<double>>> columnData(this->rows);
+    Rows columnData = Matrix::allocateRows(this->rows, 1);
     for (int i = 0; i < this->rows; i ++) {
-        columnData[i] = std::make_unique<std::vector<double>>(1, (*this->data[i])[columnIndex]);
+        columnData[i][0] = this->data[i][columnIndex];
     }
     return Matrix(std::move(columnData));
 
@@ -213,7 +273,7 @@ std::vector<float> Matrix::toVector() const {
     std::vector<float> result;
     result.reserve(this->columns * this->rows);
     for (auto&& row : this->data) {
-        result.insert(result.end(), row->begin(), row->end());
+        result.insert(result.end(), row.begin(), row.end());
     }
     return result;
 }
@@ -228,103 +288,32 @@ Matrix Matrix::multCPU(const Matrix &other) const {
             << " matrix with a " << other.rows << "x" << other.columns << " matrix.";
         throw std::invalid_argument(oss.str());
     }
-    std::vector<std::unique_ptr<std::vector<double>>> newData(this->rows);
+    Rows newData = Matrix::allocateRows(this->rows, other.columns);
     for (int i = 0; i < (int)this->rows; i ++) {
-        newData[i] = std::make_unique<std::vector<double>>(other.columns, 0);
         for (int j = 0; j < (int) other.columns; j++) {
             for (int k = 0; k < (int) this->columns; k++) {
-                (*newData[i])[j] += (*this->data[i])[k] * (*other.data[k])[j];
+                newData[i][j] += this->data[i][k] * other.data[k][j];
             }
         }
     }
     return Matrix(std::move(newData));
 }
 
-Matrix Matrix::multCPU(const double &scalar) const {
-    std::vector<std::unique_ptr<std::vector<double>>> result(this->rows);
-    for (int i = 0; i < this->rows; i ++) {
-        result[i] = std::make_unique<std::vector<double>>(this->columns);
-        for (int j = 0; j < this->columns; j ++) {
-            (*result[i])[j] = (*this)[i][j] * scalar;
-        }
-    }
-    return Matrix(std::move(result));
-}
-
-Matrix Matrix::addCPU(const Matrix &other) const {
-
-    if (this->columns != other.columns || this->rows != other.rows ) {
-        std::ostringstream oss;
-        oss << "Can't perform the addition of a " << this->rows << "x" << this->columns
-            << " matrix with a " << other.rows << "x" << other.columns << " matrix.";
-        throw std::invalid_argument(oss.str());
-    }
-    for (int i = 0; i < (int)this->rows; i ++) {
-        for (int j = 0; j < (int)this->columns; j ++) {
-            (*this->data[i])[j] += (*other.data[i])[j];
-        }
-    }
-    return *this;
-}
-
-Matrix Matrix::subCPU(const Matrix &other) const {
-    if (this->columns != other.columns || this->rows != other.rows ) {
-        std::ostringstream oss;
-        oss << "Can't perform the subtraction of a " << this->rows << "x" << this->columns
-            << " matrix with a " << other.rows << "x" << other.columns << " matrix.";
-        throw std::invalid_argument(oss.str());
-    }
-    for (int i = 0; i < (int)this->rows; i ++) {
-        for (int j = 0; j < (int)this->columns; j ++) {
-            (*this->data[i])[j] -= (*other.data[i])[j];
-        }
-    }
-    return *this;
-}
-
-Matrix Matrix::mapCPU(const std::function<double(double)> &callback) const {
-    std::vector<std::unique_ptr<std::vector<double>>> newData(this->rows);
-    for (int i = 0; i < this->rows; i ++) {
-        newData[i] = std::make_unique<std::vector<double>>(this->columns);
-        for (int j = 0; j < this->columns; j ++) {
-            (*newData[i])[j] = callback((*this->data[i])[j]);
-        }
-    }
-    return Matrix(std::move(newData));
-}
-
-Matrix Matrix::mapCPU(const Matrix &other, const std::function<double(double, double)> &callback) const {
-    if (this->rows != other.rows || this->columns != other.columns) {
-        throw std::invalid_argument("Matrices must have the same dimensions for map operation.");
-    }
-    std::vector<std::unique_ptr<std::vector<double>>> newData(this->rows);
-    for (int i = 0; i < this->rows; i++) {
-        newData[i] = std::make_unique<std::vector<double>>(this->columns);
-        for (int j = 0; j < this->columns; j++) {
-            (*newData[i])[j] = callback((*this->data[i])[j], (*other.data[i])[j]);
-        }
-    }
-    return Matrix(std::move(newData));
-}
-
 double Matrix::sumCPU() const {
     if (this->columns != 1)
         throw std::invalid_argument("Can only sum a vector or a N x 1 Matrix!");
     double sum = 0;
     for (int i = 0; i < this->rows; i ++) {
-        sum += (*this->data[i])[0];
+        sum += this->data[i][0];
     }
     return sum;
 }
 
 Matrix Matrix::transposeCPU() const {
-    std::vector<std::unique_ptr<std::vector<double>>> newData(this->columns);
-    for (int i = 0; i < this->columns; ++i) {
-        newData[i] = std::make_unique<std::vector<double>>(this->rows);
-    }
+    Rows newData = Matrix::allocateRows(this->columns, this->rows);
     for (int i = 0; i < this->rows; ++i) {
         for (int j = 0; j < this->columns; ++j) {
-            (*newData[j])[i] = (*this->data[i])[j];
+            newData[j][i] = this->data[i][j];
         }
     }
     return Matrix(std::move(newData));
@@ -332,22 +321,18 @@ Matrix Matrix::transposeCPU() const {
 
     /* Static methods */
 Matrix Matrix::identityCPU(const size_t &size) {
-    std::vector<std::unique_ptr<std::vector<double>>> data(size);
+    Rows data = Matrix::allocateRows(size, size);
     for (int i = 0; i < size; i ++) {
-        data[i] = std::make_unique<std::vector<double>>(size, 0);
-        for (int j = 0; j < size; j ++) {
-            if (i == j) (*data[i])[j] = 1;
-        }
+        data[i][i] = 1;
     }
     return Matrix(std::move(data));
 }
 
 Matrix Matrix::randomMatrixCPU(const size_t &rows, const size_t &columns) {
-    std::vector<std::unique_ptr<std::vector<double>>> data(rows);
+    Rows data = Matrix::allocateRows(rows, columns);
     for (int i = 0; i < rows; i ++) {
-        data[i] = std::make_unique<std::vector<double>>(columns);
         for (int j = 0; j < columns; j ++) {
-            (*data[i])[j] = generateRandomNeg1_1();
+            data[i][j] = generateRandomNeg1_1();
         }
     }
     return Matrix(std::move(data));
@@ -376,26 +361,6 @@ Matrix Matrix::multGPU(const Matrix &other) const {
     return Matrix::fromVector(result, other.columns, this->rows);
 }
 
-Matrix Matrix::multGPU(const double &scalar) const {
-    return *this;
-}
-
-Matrix Matrix::addGPU(const Matrix &other) const {
-    return *this;
-}
-
-Matrix Matrix::subGPU(const Matrix &other) const {
-    return *this;
-}
-
-Matrix Matrix::mapGPU(const std::function<double(double)> &callback) const {
-    return *this;
-}
-
-Matrix Matrix::mapGPU(const Matrix &other, const std::function<double(double, double)> &callback) const {
-    return *this;
-}
-
 double Matrix::sumGPU() const {
     return 0.0;
 }
@@ -418,7 +383,7 @@ std::ostream& operator << (std::ostream& o, const Matrix& matrix) {
     for (int i = 0; i < matrix.rows; i ++) {
         o << "[";
         for (int j = 0; j < matrix.columns; j ++) {
-            o << (*matrix.data[i])[j] << (j + 1 != matrix.columns ? ", " : "");
+            o << matrix.data[i][j] << (j + 1 != matrix.columns ? ", " : "");
         }
         o << "]" << (i + 1 != matrix.rows ? ",\n" : "");
     }
@@ -12,11 +12,21 @@
 #include <sstream>
 #include <random>
 #include <ostream>
+#include "./arena.h"
 #include "./env.h"
 #include "./GPUfunctions.h"
+#include "./matrix-expression.h"
+#include "./profiler.h"
 
-class Matrix {
+/* MATRIX MACROS */
+#define MATRIX_BLOCK_COLUMNS 8        // output columns blockMultiply accumulates at once, two AVX2 registers
+
+class Matrix : public MatrixExpression<Matrix> {
 public:
+    /* rows are allocated wherever the creating thread allocates, see arena.h */
+    using Row = std::vector<double, StepAllocator<double>>;
+    using Rows = std::vector<Row, StepAllocator<Row>>;
+
     /* Static methods */
     static Matrix identity(const size_t& size);
     static Matrix randomMatrix(const size_t& rows, const size_t& columns);
@@ -24,35 +34,57 @@ public:
     static Matrix nullVector(const size_t& size);
     static Matrix randomVector(const size_t& size);
     static Matrix fromVector(const std::vector<float>& result, const size_t& columns, const size_t& rows);
+    static Matrix columnVector(const std::vector<double>& values);
+    static Matrix fromColumns(const std::vector<std::vector<double>>& columns);
+    /* rows x columns zeros, to be filled before building a matrix out of them */
+    static Rows allocateRows(const size_t& rows, const size_t& columns);
 
 
     /* Constructor */
     Matrix() = default;
-    explicit Matrix(std::vector<std::unique_ptr<std::vector<double>>> data);
+    explicit Matrix(Rows data);
+    /* copies the rows */
+    explicit Matrix(const std::vector<std::unique_ptr<std::vector<double>>>& data);
 
     /* Copy constructors */
     Matrix(const Matrix& other);
     Matrix& operator = (const Matrix& other);
 
+    /* Move constructors */
+    /* takes the other matrix's memory as is, arena memory included (see arena.h) */
+    Matrix(Matrix&& other) noexcept;
+    /* copies when the other matrix's memory comes from elsewhere, which allocates and so may throw */
+    Matrix& operator = (Matrix&& other);
+
+    /* Evaluates an element-wise expression, see matrix-expression.h */
+    template <typename E>
+    Matrix(const MatrixExpression<E>& expression);
+    template <typename E>
+    Matrix& operator = (const MatrixExpression<E>& expression);
+
     /* Default Destroyer */
     ~Matrix() = default;
 
     /* Operators */
+    /* Operators, element-wise +, - and scalar * are lazy and declared in matrix-expression.h */
     Matrix operator * (const Matrix& other) const;
     Matrix& operator *= (const Matrix& other);
-    Matrix operator * (const double& other) const;
     Matrix& operator *= (const double& other);
-    Matrix operator + (const Matrix& other) const;
-    Matrix& operator += (const Matrix& other);
-    Matrix operator - (const Matrix& other) const;
-    Matrix& operator -= (const Matrix& other);
+    template <typename E>
+    Matrix& operator += (const MatrixExpression<E>& other);
+    template <typename E>
+    Matrix& operator -= (const MatrixExpression<E>& other);
     std::vector<double> operator [] (int index) const;
+    double operator () (const size_t& row, const size_t& column) const { return this->data[row][column]; }
 
     /* Class Methods */
     [[nodiscard]] Matrix transpose() const;
+    /*
+     * this and other both hold `blocks` matrices stacked on top of each other, the result stacks the products of
+     * the i-th block of this with the i-th block of other: a block-diagonal product that skips the zero blocks
+     * */
+    [[nodiscard]] Matrix blockMultiply(const Matrix& other, const size_t& blocks) const;
 
-    Matrix map(const std::function<double(double)>& callback) const;
-    Matrix map(const Matrix& other, const std::function<double(double, double)>& callback) const;
     double sum();
     [[nodiscard]] Matrix clone() const;
     Matrix getColumn(size_t columnIndex) const;
@@ -64,22 +96,16 @@ public:
     friend std::ostream& operator << (std::ostream& o, const Matrix& matrix);
 
 private:
-    size_t rows;
-    size_t columns;
-    // this may seem dumb, but it forces no copies of the data, leading to better performances.
+    size_t rows = 0;
+    size_t columns = 0;
     // data is of the form data[][], or size(data) is the size of the rows and size(data[n]) is
     // the size of the columns
-    std::vector<std::unique_ptr<std::vector<double>>> data;
+    Rows data;
     std::shared_ptr<GPUMatrixMultiplier> gpuMatrixMultiplier;
 
 
     /* CPU implementations */
     [[nodiscard]] Matrix multCPU(const Matrix& other) const;
-    [[nodiscard]] Matrix multCPU(const double& scalar) const;
-    [[nodiscard]] Matrix addCPU(const Matrix& other) const;
-    [[nodiscard]] Matrix subCPU(const Matrix& other) const;
-    [[nodiscard]] Matrix mapCPU(const std::function<double(double)>& callback) const;
-    [[nodiscard]] Matrix mapCPU(const Matrix& other, const std::function<double(double, double)>& callback) const;
     [[nodiscard]] double sumCPU() const;
     [[nodiscard]] Matrix transposeCPU() const;
     static Matrix identityCPU(const size_t& size);
@@ -88,16 +114,69 @@ private:
 
     /* GPU implementations */
     [[nodiscard]] Matrix multGPU(const Matrix& other) const;
-    [[nodiscard]] Matrix multGPU(const double& scalar) const;
-    [[nodiscard]] Matrix addGPU(const Matrix& other) const;
-    [[nodiscard]] Matrix subGPU(const Matrix& other) const;
-    [[nodiscard]] Matrix mapGPU(const std::function<double(double)>& callback) const;
-    [[nodiscard]] Matrix mapGPU(const Matrix& other, const std::function<double(double, double)>& callback) const;
     [[nodiscard]] double sumGPU() const;
     [[nodiscard]] Matrix transposeGPU() const;
     static Matrix identityGPU(const size_t& size);
     static Matrix randomMatrixGPU(const size_t& rows, const size_t& columns);
 
+    /* Element-wise expression evaluation, always a single loop on the host */
+    template <typename E, typename F>
+    void evaluateInPlace(const MatrixExpression<E>& expression, F assign, const char* operation);
 };
 
+/* Expression template members */
+template <typename E>
+Matrix::Matrix(const MatrixExpression<E>& expression) {
+    this->rows = expression.getRowSize();
+    this->columns = expression.getColumnSize();
+    this->data = Matrix::allocateRows(this->rows, this->columns);
+    Profiler::allocated(this->rows * this->columns * sizeof(double));
+    for (size_t i = 0; i < this->rows; i ++) {
+        for (size_t j = 0; j < this->columns; j ++) {
+            this->data[i][j] = expression(i, j);
+        }
+    }
+}
+
+template <typename E>
+Matrix& Matrix::operator = (const MatrixExpression<E>& expression) {
+    if (this->rows != expression.getRowSize() || this->columns != expression.getColumnSize()) {
+        // the shape changes, so the expression can't be reading from this matrix
+        *this = Matrix(expression);
+        return *this;
+    }
+    // element (i, j) of an element-wise expression only reads element (i, j) of its operands, so the
+    // destination can safely appear in its own expression, e.g. m = m * 0.9 + g * 0.1
+    this->evaluateInPlace(expression, [](double& destination, const double& value) { destination = value; }, "assignment");
+    return *this;
+}
+
+template <typename E>
+Matrix& Matrix::operator += (const MatrixExpression<E>& other) {
+    this->evaluateInPlace(other, [](double& destination, const double& value) { destination += value; }, "addition");
+    return *this;
+}
+
+template <typename E>
+Matrix& Matrix::operator -= (const MatrixExpression<E>& other) {
+    this->evaluateInPlace(other, [](double& destination, const double& value) { destination -= value; }, "subtraction");
+    return *this;
+}
+
+template <typename E, typename F>
+void Matrix::evaluateInPlace(const MatrixExpression<E>& expression, F assign, const char* operation) {
+    if (this->rows != expression.getRowSize() || this->columns != expression.getColumnSize()) {
+        std::ostringstream oss;
+        oss << "Can't perform the " << operation << " of a " << this->rows << "x" << this->columns
+            << " matrix with a " << expression.getRowSize() << "x" << expression.getColumnSize() << " matrix.";
+        throw std::invalid_argument(oss.str());
+    }
+    for (size_t i = 0; i < this->rows; i ++) {
+        Row& row = this->data[i];
+        for (size_t j = 0; j < this->columns; j ++) {
+            assign(row[j], expression(i, j));
+        }
+    }
+}
+
 #endif // MATRIX_H
@@ -5,12 +5,14 @@
 #include "model.h"
 #include "visitor.h"
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
 /* Utility function */
-std::vector<size_t> generateRandomIndices(size_t size) {
+std::vector<size_t> generateRandomIndices(size_t size, std::mt19937& g) {
     std::vector<size_t> indices(size);
     std::iota(indices.begin(), indices.end(), 0); // Fill with 0, 1, ..., size-1
-    std::random_device rd;
-    std::mt19937 g(rd());
     std::shuffle(indices.begin(), indices.end(), g);
     return indices;
 }
@@ -18,6 +20,10 @@ std::vector<size_t> generateRandomIndices(size_t size) {
 Model::Model(const size_t &numberOfInputs, const ActivationFunction &activation, std::unique_ptr<LossFunction> lossFunction) {
     this->inputLayer = std::make_unique<InputLayer>(activation, numberOfInputs);
     this->lastEpochNumber = -1;
+    this->revision = 0;
+    this->random.seed(std::random_device()());
+    this->checkpointInterval = 0;
+    this->verbose = true;
     this->lossFunction = std::move(lossFunction);
     this->gpuMatrixMultiplier = std::make_shared<GPUMatrixMultiplier>();
     this->gpuMatrixMultiplier->init();
@@ -34,52 +40,260 @@ void Model::addLayer(const ActivationFunction &f, const size_t &neuronCount) {
 
 void Model::trainNetwork(const std::vector<Matrix> &inputX, const std::vector<Matrix> &inputY,
                     const int &epochs, const size_t &batchSize) {
+    this->trainNetwork(inputX, inputY, epochs, batchSize, {}, {}, EarlyStopping());
+}
+
+void Model::trainNetwork(const std::vector<Matrix> &inputX, const std::vector<Matrix> &inputY, const int &epochs,
+                         const size_t &batchSize, const std::vector<Matrix> &validationX,
+                         const std::vector<Matrix> &validationY, const EarlyStopping &earlyStopping) {
+    this->train(inputX, inputY, nullptr, epochs, batchSize, validationX, validationY, earlyStopping);
+}
+
+void Model::trainNetwork(const std::vector<Matrix> &inputX, const std::vector<Matrix> &inputY,
+                         const std::vector<size_t> &samples, const int &epochs, const size_t &batchSize) {
+    this->train(inputX, inputY, &samples, epochs, batchSize, {}, {}, EarlyStopping());
+}
+
+void Model::train(const std::vector<Matrix> &inputX, const std::vector<Matrix> &inputY, const std::vector<size_t> *samples,
+                  const int &epochs, const size_t &batchSize, const std::vector<Matrix> &validationX,
+                  const std::vector<Matrix> &validationY, const EarlyStopping &earlyStopping) {
     if (inputX.size() != inputY.size())
         throw std::invalid_argument("InputX and InputY must be of the same length");
+    if (samples && std::any_of(samples->begin(), samples->end(), [&inputX](const size_t& index) { return index >= inputX.size(); }))
+        throw std::invalid_argument("Sample index out of range");
+    // the samples trained on, all of them or the given subset, without copying the dataset
+    const size_t sampleCount = samples ? samples->size() : inputX.size();
+    const auto sample = [samples](const size_t& j) { return samples ? (*samples)[j] : j; };
+    if (validationX.size() != validationY.size())
+        throw std::invalid_argument("ValidationX and ValidationY must be of the same length");
+    if (earlyStopping.interval == 0)
+        throw std::invalid_argument("The validation interval must be of at least one epoch!");
+
+    const bool validating = !validationX.empty();
+    int firstEpoch = 0;
+    ValidationProgress validation;
+    if (this->resumed) {
+        firstEpoch = this->resumed->epoch;
+        validation = std::move(this->resumed->validation);
+        this->resumed.reset();
+    }
+    /*
+     * prints the epoch's loss, runs the validation check and hands a checkpoint to the writer when they are due,
+     * true once training should stop
+     * */
+    const auto endEpoch = [&](const int& epoch, const double& lossAtEpoch) {
+        if (this->verbose) std::cout << "Loss at Epoch " << epoch + 1 << " : " << lossAtEpoch / static_cast<double>(sampleCount) << std::endl;
+        if (Profiler::isEnabled()) Profiler::printSummary(std::cout);
+        bool stop = false;
+        if (validating && (epoch + 1) % earlyStopping.interval == 0) {
+            const double validationLoss = this->evaluateLoss(validationX, validationY, earlyStopping.batchSize);
+            if (this->verbose) std::cout << "Validation loss at Epoch " << epoch + 1 << " : " << validationLoss << std::endl;
+            if (validationLoss < validation.bestLoss - earlyStopping.minDelta) {
+                validation.bestLoss = validationLoss;
+                validation.bestEpoch = epoch;
+                validation.checksWithoutImprovement = 0;
+                if (earlyStopping.restoreBest) validation.bestParameters = this->getParameters();
+            }
+            else stop = earlyStopping.patience && ++ validation.checksWithoutImprovement >= earlyStopping.patience;
+        }
+        if (this->checkpointInterval && ((epoch + 1) % this->checkpointInterval == 0 || stop || epoch + 1 == epochs))
+            this->checkpointWriter->submit(this->checkpointPath, this->checkpoint(epoch + 1, validation));
+        return stop;
+    };
 
     double lossAtEpoch;
+    // kept across the steps so their capacity is reused, they are emptied before the arena is reset
+    std::vector<Matrix> batchInputsX;
+    std::vector<Matrix> batchInputsY;
+    std::vector<Matrix> results;
     if (batchSize == 1) {
-        Matrix lastPrediction;
-        for (int i = 0; i < epochs; i ++) {
+        for (int i = firstEpoch; i < epochs; i ++) {
             lossAtEpoch = 0.;
-            for (int j = 0; j < inputY.size(); j ++) {
-                lastPrediction = this->inputLayer->forwardFeed(inputX[j]);
-                this->trainStochastic(inputX[j], inputY[j], lastPrediction);
-                lossAtEpoch += this->lossFunction->loss(lastPrediction, inputY[j]);
+            this->epochErrors.reset();
+            for (size_t j = 0; j < sampleCount; j ++) {
+                // every temporary of the step comes from the arena, reset once the optimizers are done with it
+                StepArena::Scope step(this->arena);
+                batchInputsX.push_back(inputX[sample(j)]);
+                batchInputsY.push_back(inputY[sample(j)]);
+                results.push_back(this->inputLayer->forwardFeed(inputX[sample(j)]));
+                this->trainBatch(batchInputsX, batchInputsY, results);
+                {
+                    ScopedTimer timer(ProfilePhase::LOSS, PROFILER_MODEL_LAYER);
+                    lossAtEpoch += this->lossFunction->loss(results[0], inputY[sample(j)]);
+                    this->epochErrors.add(inputY[sample(j)], results[0]);
+                }
+                batchInputsX.clear();
+                batchInputsY.clear();
+                results.clear();
             }
-            std::cout << "Loss at Epoch " << i + 1<< " : " << lossAtEpoch / (double)inputY.size() << std::endl;
+            if (endEpoch(i, lossAtEpoch)) break;
         }
     } else {
-        for (int i = 0; i < epochs; i ++) {
-            std::vector<size_t> indices = generateRandomIndices(inputX.size());
+        for (int i = firstEpoch; i < epochs; i ++) {
+            std::vector<size_t> indices = generateRandomIndices(sampleCount, this->random);
             lossAtEpoch = 0;
+            this->epochErrors.reset();
             for (size_t start = 0; start < indices.size(); start += batchSize) {
-                std::vector<Matrix> batchInputsX;
-                std::vector<Matrix> batchInputsY;
-                std::vector<Matrix> results;
-
+                StepArena::Scope step(this->arena);
                 for (size_t j = start; j < start + batchSize && j < indices.size(); j ++) {
-                    batchInputsX.push_back(inputX[indices[j]]);
-                    batchInputsY.push_back(inputY[indices[j]]);
-                    results.push_back(this->inputLayer->forwardFeed(inputX[indices[j]]));
+                    batchInputsX.push_back(inputX[sample(indices[j])]);
+                    batchInputsY.push_back(inputY[sample(indices[j])]);
+                    results.push_back(this->inputLayer->forwardFeed(inputX[sample(indices[j])]));
                 }
 
                 this->trainBatch(batchInputsX, batchInputsY, results);
 
                 for (size_t j = 0; j < batchInputsX.size(); j ++) {
                     Matrix prediction = this->inputLayer->forwardFeed(batchInputsX[j]);
+                    ScopedTimer timer(ProfilePhase::LOSS, PROFILER_MODEL_LAYER);
                     lossAtEpoch += this->lossFunction->loss(prediction, batchInputsY[j]);
+                    this->epochErrors.add(batchInputsY[j], prediction);
                 }
+                batchInputsX.clear();
+                batchInputsY.clear();
+                results.clear();
             }
-            std::cout << "Loss at Epoch " << i + 1<< " : " << lossAtEpoch / static_cast<double>(inputY.size()) << std::endl;
+            if (endEpoch(i, lossAtEpoch)) break;
+        }
+    }
+    if (this->checkpointWriter) this->checkpointWriter->flush();
+    if (validation.bestEpoch >= 0) {
+        if (this->verbose) std::cout << "Best validation loss : " << validation.bestLoss << " at Epoch " << validation.bestEpoch + 1 << std::endl;
+        if (earlyStopping.restoreBest && !validation.bestParameters.empty()) this->setParameters(validation.bestParameters);
+    }
+    this->revision ++;
+}
+
+void Model::setCheckpoints(const std::string &path, const size_t &interval) {
+    if (interval && path.empty())
+        throw std::invalid_argument("Checkpoints need a path!");
+    this->checkpointPath = path;
+    this->checkpointInterval = interval;
+    if (interval && !this->checkpointWriter) this->checkpointWriter = std::make_unique<CheckpointWriter>();
+}
+
+void Model::resume(const std::string &path) {
+    Checkpoint checkpoint = Checkpoint::read(path);
+    this->setParameters(checkpoint.parameters);
+    size_t index = 0;
+    std::shared_ptr<Layer> layer = this->inputLayer;
+    while (layer) {
+        if (index >= checkpoint.optimizers.size())
+            throw std::invalid_argument("The checkpoint doesn't match the model's layers!");
+        const OptimizerState& state = checkpoint.optimizers[index ++];
+        if (layer->getOptimizer()) layer->getOptimizer()->setState(state);
+        else if (state.step || !state.caches.empty())
+            throw std::invalid_argument("Select the optimizer the checkpoint was trained with before resuming!");
+        layer = layer->getNextLayer();
+    }
+    std::istringstream randomState(checkpoint.randomState);
+    randomState >> this->random;
+    if (!randomState) throw std::runtime_error("The checkpoint's random state is corrupted!");
+
+    checkpoint.parameters.clear();
+    checkpoint.optimizers.clear();
+    this->resumed = std::make_unique<Checkpoint>(std::move(checkpoint));
+    this->revision ++;
+    if (this->verbose) std::cout << "Resuming after Epoch " << this->resumed->epoch << std::endl;
+}
 
+Checkpoint Model::checkpoint(const int &epoch, const ValidationProgress &validation) const {
+    Checkpoint checkpoint;
+    checkpoint.epoch = epoch;
+    checkpoint.parameters = this->getParameters();
+    std::shared_ptr<Layer> layer = this->inputLayer;
+    while (layer) {
+        checkpoint.optimizers.push_back(layer->getOptimizer() ? layer->getOptimizer()->getState() : OptimizerState());
+        layer = layer->getNextLayer();
+    }
+    std::ostringstream randomState;
+    randomState << this->random;
+    checkpoint.randomState = randomState.str();
+    checkpoint.validation = validation;
+    return checkpoint;
+}
+
+double Model::evaluateLoss(const std::vector<Matrix> &X, const std::vector<Matrix> &Y, const size_t &batchSize) {
+    return this->evaluate(X, Y, nullptr, batchSize, nullptr);
+}
+
+double Model::evaluateLoss(const std::vector<Matrix> &X, const std::vector<Matrix> &Y, const std::vector<size_t> &samples,
+                           ErrorMetrics *errors, const size_t &batchSize) {
+    return this->evaluate(X, Y, &samples, batchSize, errors);
+}
+
+double Model::evaluate(const std::vector<Matrix> &X, const std::vector<Matrix> &Y, const std::vector<size_t> *samples,
+                       const size_t &batchSize, ErrorMetrics *errors) {
+    if (X.size() != Y.size())
+        throw std::invalid_argument("X and Y must be of the same length");
+    if (samples && std::any_of(samples->begin(), samples->end(), [&X](const size_t& index) { return index >= X.size(); }))
+        throw std::invalid_argument("Sample index out of range");
+    const size_t sampleCount = samples ? samples->size() : X.size();
+    const auto sample = [samples](const size_t& j) { return samples ? (*samples)[j] : j; };
+    if (!sampleCount) return 0.;
+    const size_t step = std::max<size_t>(batchSize, 1);
+    const size_t inputs = X[sample(0)].getRowSize();
+    double loss = 0.;
+    for (size_t start = 0; start < sampleCount; start += step) {
+        StepArena::Scope scope(this->arena);
+        const size_t size = std::min(step, sampleCount - start);
+        Matrix::Rows columns = Matrix::allocateRows(inputs, size);
+        for (size_t j = 0; j < size; j ++) {
+            for (size_t i = 0; i < inputs; i ++) {
+                columns[i][j] = X[sample(start + j)](i, 0);
+            }
+        }
+        const Matrix predictions = this->predictBatch(Matrix(std::move(columns)));
+        for (size_t j = 0; j < size; j ++) {
+            loss += this->lossFunction->loss(predictions.getColumn(j), Y[sample(start + j)]);
+            if (errors) errors->add(Y[sample(start + j)], predictions, j);
         }
     }
+    return loss / static_cast<double>(sampleCount);
+}
+
+std::vector<Matrix> Model::getParameters() const {
+    std::vector<Matrix> parameters;
+    std::shared_ptr<Layer> layer = this->inputLayer;
+    while (layer) {
+        parameters.push_back(layer->getWeight());
+        parameters.push_back(layer->getBiases());
+        layer = layer->getNextLayer();
+    }
+    return parameters;
 }
 
-void Model::trainStochastic(const Matrix &inputX, const Matrix &inputY, const Matrix &resultY) {
-    this->backPropagate(std::vector<Matrix>(1, inputY), std::vector<Matrix>(1, resultY), std::vector<Matrix>(1, inputX), 0);
-    this->inputLayer->gradientDescent(std::vector<Matrix>(1, inputX));
+void Model::setParameters(const std::vector<Matrix> &parameters) {
+    // checked before anything is set, a mismatch leaves the model as it was
+    size_t index = 0;
+    for (std::shared_ptr<Layer> layer = this->inputLayer; layer; layer = layer->getNextLayer(), index += 2) {
+        const size_t neurons = layer->getNeuronCount();
+        const size_t activations = layer->getPreviousLayer() ? layer->getPreviousLayer()->getNeuronCount() : neurons;
+        if (index + 1 >= parameters.size() || parameters[index].getRowSize() != neurons || parameters[index].getColumnSize() != activations
+                || parameters[index + 1].getRowSize() != neurons || parameters[index + 1].getColumnSize() != 1)
+            throw std::invalid_argument("The parameters don't match the model's layers!");
+    }
+    if (index != parameters.size())
+        throw std::invalid_argument("The parameters don't match the model's layers!");
+
+    index = 0;
+    for (std::shared_ptr<Layer> layer = this->inputLayer; layer; layer = layer->getNextLayer()) {
+        layer->setWeights(parameters[index ++]);
+        layer->setBiases(parameters[index ++]);
+    }
+    this->inputLayer->setMatrixMultiplier(this->gpuMatrixMultiplier);
+    this->revision ++;
+}
+
+void Model::setInputParameters(const Matrix &weights, const Matrix &biases) {
+    const Matrix current = this->inputLayer->getWeight();
+    if (weights.getRowSize() != current.getRowSize() || weights.getColumnSize() != current.getColumnSize()
+            || biases.getRowSize() != current.getRowSize() || biases.getColumnSize() != 1)
+        throw std::invalid_argument("The parameters don't match the model's input layer!");
+    this->inputLayer->setWeights(weights);
+    this->inputLayer->setBiases(biases);
+    this->inputLayer->setMatrixMultiplier(this->gpuMatrixMultiplier);
+    this->revision ++;
 }
 
 void Model::trainBatch(const std::vector<Matrix> &inputsX, const std::vector<Matrix> &inputsY, const std::vector<Matrix> &resultsY) {
@@ -132,6 +346,13 @@ void Model::save(const std::string& filePath) {
     visitor.doSomethingWithActivations(this);
 }
 
+void Model::saveHeader(const std::string& filePath, const std::string& name) {
+    HeaderExportVisitor visitor(filePath, name);
+    visitor.doSomethingWithWeight(this);
+    visitor.doSomethingWithBias(this);
+    visitor.doSomethingWithActivations(this);
+}
+
 std::unique_ptr<Model> Model::importModel(const std::string &filePath) {
     std::unique_ptr<Model> m = std::make_unique<Model>(1, NoActivation(), std::make_unique<MSE>(0.01)) ;
     ImportVisitor visitor(filePath);
@@ -143,31 +364,30 @@ std::unique_ptr<Model> Model::importModel(const std::string &filePath) {
 
 void Model::calculateDels(const Matrix &targetY, const Matrix &predictedY, const Matrix &inputX,
                           const std::shared_ptr<Layer>& currentLayer) const {
+    ScopedTimer timer(ProfilePhase::CALCULATE_DELS, currentLayer->getLayerNumber());
     if (!currentLayer->isNextLayer()) {
-        std::vector<std::unique_ptr<std::vector<double>>> newDelVals(currentLayer->getNeuronCount());
-        double delVal;
+        Matrix::Rows newDelVals = Matrix::allocateRows(currentLayer->getNeuronCount(), 1);
+        // neither depends on the neuron, they are computed once for the whole layer
+        this->lossFunction->setWeightsSquaredSum(currentLayer->getWeight());
+        const Matrix outputs = this->inputLayer->forwardFeedUntilLayer(inputX, currentLayer->getLayerNumber());
         for (int i = 0; i < currentLayer->getNeuronCount(); i ++) {
-            this->lossFunction->setWeightsSquaredSum(currentLayer->getWeight().toVector());
-            delVal = this->lossFunction->derivative(predictedY[i][0], targetY[i][0]) *
-                     currentLayer->getActivationDerivative(
-                             this->inputLayer->forwardFeedUntilLayer(inputX, currentLayer->getLayerNumber())[i][0]
-                     );
-            newDelVals[i] = std::make_unique<std::vector<double>>(1, delVal);
+            newDelVals[i][0] = this->lossFunction->derivative(predictedY(i, 0), targetY(i, 0)) *
+                               currentLayer->getActivationDerivative(outputs(i, 0));
         }
         currentLayer->updateDels(Matrix(std::move(newDelVals)));
     }
     else {
         double sumOfNextDels = currentLayer->getNextLayer()->getSumDels();
-        std::vector<std::unique_ptr<std::vector<double>>> delValsForLayer(currentLayer->getNeuronCount());
+        Matrix::Rows delValsForLayer = Matrix::allocateRows(currentLayer->getNeuronCount(), 1);
 
         Matrix activations = this->inputLayer->forwardFeedUntilLayer(inputX, currentLayer->getLayerNumber());
         double columnSumOfWeights, delValue, derivative;
         for (int i = 0; i < currentLayer->getNeuronCount(); i ++) {
             columnSumOfWeights = currentLayer->getNextLayer()->getColumnSumWeights(i);
             delValue = sumOfNextDels * columnSumOfWeights;
-            derivative = currentLayer->getActivationDerivative(activations[i][0]);
+            derivative = currentLayer->getActivationDerivative(activations(i, 0));
             delValue *= derivative;
-            delValsForLayer[i] = std::make_unique<std::vector<double>>(1, delValue);
+            delValsForLayer[i][0] = delValue;
         }
         currentLayer->updateDels(Matrix(std::move(delValsForLayer)));
     }
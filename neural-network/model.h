@@ -14,10 +14,24 @@
 #include "loss-functions.h"
 #include "layers.h"
 #include "optimizers.h"
+#include "error-histogram.h"
+#include "checkpoint.h"
 #include "GPUfunctions.h"
 
+/* EARLY STOPPING DEFAULTS */
+#define DEFAULT_VALIDATION_BATCH_SIZE 256
+
 class Visitor;
 
+/* when and how trainNetwork checks its validation data, a patience of 0 runs every epoch */
+struct EarlyStopping {
+    size_t patience = 0;            // validation checks in a row without improvement before training stops
+    size_t interval = 1;            // epochs between two validation checks
+    double minDelta = 0.;           // smaller decreases of the validation loss don't count as improvements
+    size_t batchSize = DEFAULT_VALIDATION_BATCH_SIZE;
+    bool restoreBest = true;        // ends training with the parameters of the best validation check
+};
+
 class Model {
 public:
 
@@ -31,31 +45,106 @@ public:
                       const int& epochs,
                       const size_t& batchSize);
 
+    /* also measures the loss on the validation data every earlyStopping.interval epochs, see EarlyStopping */
+    void trainNetwork(const std::vector<Matrix>& inputX,
+                      const std::vector<Matrix>& inputY,
+                      const int& epochs,
+                      const size_t& batchSize,
+                      const std::vector<Matrix>& validationX,
+                      const std::vector<Matrix>& validationY,
+                      const EarlyStopping& earlyStopping);
+
+    /* trains on the samples at the given indices of inputX and inputY only, e.g. the training part of a fold */
+    void trainNetwork(const std::vector<Matrix>& inputX,
+                      const std::vector<Matrix>& inputY,
+                      const std::vector<size_t>& samples,
+                      const int& epochs,
+                      const size_t& batchSize);
+
+    /* mean loss of the samples, predicted batchSize at a time */
+    double evaluateLoss(const std::vector<Matrix>& X, const std::vector<Matrix>& Y, const size_t& batchSize = DEFAULT_VALIDATION_BATCH_SIZE);
+
+    /* mean loss of the samples at the given indices, their absolute errors are added to errors when it isn't null */
+    double evaluateLoss(const std::vector<Matrix>& X, const std::vector<Matrix>& Y, const std::vector<size_t>& samples,
+                        ErrorMetrics* errors = nullptr, const size_t& batchSize = DEFAULT_VALIDATION_BATCH_SIZE);
+
+    /*
+     * trainNetwork writes a Checkpoint to path every interval epochs, and once it stops, on a background thread.
+     * An interval of 0 turns checkpoints off
+     * */
+    void setCheckpoints(const std::string& path, const size_t& interval);
+
+    /*
+     * restores a checkpoint of a model built like this one, optimizer included, the next trainNetwork carries
+     * on after the checkpoint's epoch and ends at the same epoch count as the interrupted one
+     * */
+    void resume(const std::string& path);
+
+    /* every layer's weights then biases, from the input layer to the output one */
+    std::vector<Matrix> getParameters() const;
+    void setParameters(const std::vector<Matrix>& parameters);
+
+    /* replaces the input layer's weights and biases, e.g. with a scaling folded in, caches of the predictions go stale */
+    void setInputParameters(const Matrix& weights, const Matrix& biases);
+
     void addLayer(const ActivationFunction& f, const size_t& neuronCount);
 
     void selectOptimiser(std::unique_ptr<Optimizer> o);
 
+    /* whether trainings print their losses, on by default */
+    void setVerbose(const bool& verbose) { this->verbose = verbose; }
+
     void save(const std::string& filePath);
 
+    void saveHeader(const std::string& filePath, const std::string& name);
+
     Matrix predict(const Matrix& input) { return this->inputLayer->forwardFeed(input); }
 
+    /* one forward pass for a whole batch, the inputs hold one sample per column and so does the result */
+    Matrix predictBatch(const Matrix& inputs) { return this->inputLayer->forwardFeed(inputs); }
+
+    /* changes every time the network is trained or its parameters are set, lets caches of its predictions know they are stale */
+    size_t getRevision() const { return this->revision; }
+
     std::shared_ptr<InputLayer> getInputLayer() const { return this->inputLayer; }
 
+    /* per output absolute errors of the predictions the last training epoch measured its loss on */
+    const ErrorMetrics& getEpochErrors() const { return this->epochErrors; }
+
 private:
 
-    void trainStochastic(const Matrix& inputX, const Matrix& inputY, const Matrix& resultY);
+    /* samples is null to train on every sample */
+    void train(const std::vector<Matrix>& inputX, const std::vector<Matrix>& inputY, const std::vector<size_t>* samples,
+               const int& epochs, const size_t& batchSize, const std::vector<Matrix>& validationX,
+               const std::vector<Matrix>& validationY, const EarlyStopping& earlyStopping);
+
+    double evaluate(const std::vector<Matrix>& X, const std::vector<Matrix>& Y, const std::vector<size_t>* samples,
+                    const size_t& batchSize, ErrorMetrics* errors);
 
     void trainBatch(const std::vector<Matrix>& inputsX, const std::vector<Matrix> &inputsY, const std::vector<Matrix> &resultsY);
 
     void backPropagate(const std::vector<Matrix>& targetY, const std::vector<Matrix>& predictedY, const std::vector<Matrix>& inputX, const int& layerNumber);
 
     void calculateDels(const Matrix& targetY, const Matrix& predictedY, const Matrix& inputX, const std::shared_ptr<Layer>& currentLayer) const;
+
+    Checkpoint checkpoint(const int& epoch, const ValidationProgress& validation) const;
     // attributes
     std::shared_ptr<InputLayer> inputLayer;
     std::unique_ptr<LossFunction> lossFunction;
     std::shared_ptr<GPUMatrixMultiplier> gpuMatrixMultiplier;
     // std::unique_ptr<Optimizer> optimizer;
     int lastEpochNumber;
+    size_t revision;
+    bool verbose;
+    // temporaries of the training steps
+    StepArena arena;
+    ErrorMetrics epochErrors;
+    // shuffles the batches, part of the checkpoints so a resumed training sees the same batches
+    std::mt19937 random;
+    std::string checkpointPath;
+    size_t checkpointInterval;
+    std::unique_ptr<CheckpointWriter> checkpointWriter;
+    std::unique_ptr<Checkpoint> resumed;        // epoch and validation progress for the next training
 };
 
 #endif // MODEL_H
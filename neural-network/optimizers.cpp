@@ -4,13 +4,27 @@
 
 #include "optimizers.h"
 
+/* Utility functions */
+namespace {
+
+    void checkState(const OptimizerState& state, const size_t& caches, const bool& counted, const std::string& name) {
+        if (state.caches.size() != caches || (!counted && state.step != 0) || state.step < 0)
+            throw std::invalid_argument("The optimizer state doesn't belong to " + name + "!");
+    }
+
+}
+
+void Optimizer::setState(const OptimizerState &state) {
+    checkState(state, 0, false, "an optimizer without state");
+}
+
 /* No optimization */
 void NoOptimization::updateWeights(Matrix &weights, const Matrix &gradients) const {
-    weights -= gradients.map([this](double x) { return x * this->learningRate; });
+    weights -= gradients * this->learningRate;
 }
 
 void NoOptimization::updateBiases(Matrix &biases, const Matrix &gradients) const {
-    biases -= gradients.map([this](double x) { return x * -this->learningRate; });
+    biases -= gradients * -this->learningRate;
 }
 
 std::unique_ptr<Optimizer> NoOptimization::clone() const {
@@ -46,6 +60,16 @@ std::unique_ptr<Optimizer> RMSPROP::clone() const {
     return std::make_unique<RMSPROP>(this->learningRate);
 }
 
+OptimizerState RMSPROP::getState() const {
+    return {0, {this->weightGradCache, this->biasGradCache}};
+}
+
+void RMSPROP::setState(const OptimizerState &state) {
+    checkState(state, 2, false, "RMSPROP");
+    this->weightGradCache = state.caches[0];
+    this->biasGradCache = state.caches[1];
+}
+
 /* ADAM */
 void ADAM::updateWeights(Matrix &weights, const Matrix &gradients) const {
     if (!m.getRowSize()) {
@@ -56,11 +80,12 @@ void ADAM::updateWeights(Matrix &weights, const Matrix &gradients) const {
     m = m * ADAM_DECAY_RATE_1 + gradients * (1 - ADAM_DECAY_RATE_1);
     v = v * ADAM_DECAY_RATE_2 + gradients.map([](double x) { return x * x; }) * (1 - ADAM_DECAY_RATE_2);
 
-    Matrix mHat = m.map([this](double x) { return x / (1 - std::pow(ADAM_DECAY_RATE_1, t)); });
-    Matrix vHat = v.map([this](double x) { return x / (1 - std::pow(ADAM_DECAY_RATE_2, t)); });
+    /* bias corrections, mHat = m / correction1 and vHat = v / correction2 */
+    const double correction1 = 1 - std::pow(ADAM_DECAY_RATE_1, t);
+    const double correction2 = 1 - std::pow(ADAM_DECAY_RATE_2, t);
 
-    weights -= mHat.map(vHat, [this](double x, double cache) {
-        return learningRate * x / (std::sqrt(cache) + ADAM_EPSILON);
+    weights -= m.map(v, [this, correction1, correction2](double x, double cache) {
+        return learningRate * (x / correction1) / (std::sqrt(cache / correction2) + ADAM_EPSILON);
     });
 }
 
@@ -73,12 +98,11 @@ void ADAM::updateBiases(Matrix &biases, const Matrix &gradients) const {
     mb = mb * ADAM_DECAY_RATE_1 + gradients * (1 - ADAM_DECAY_RATE_1);
     vb = vb * ADAM_DECAY_RATE_2 + gradients.map([](double x) { return x * x; }) * (1 - ADAM_DECAY_RATE_2);
 
+    const double correction1 = 1 - std::pow(ADAM_DECAY_RATE_1, t);
+    const double correction2 = 1 - std::pow(ADAM_DECAY_RATE_2, t);
 
-    Matrix mHat = mb.map([this](double x) { return x / (1 - std::pow(ADAM_DECAY_RATE_1, t)); });
-    Matrix vHat = vb.map([this](double x) { return x / (1 - std::pow(ADAM_DECAY_RATE_2, t)); });
-
-    biases -= mHat.map(vHat, [this](double x, double cache) {
-        return learningRate * x / (std::sqrt(cache) + ADAM_EPSILON);
+    biases -= mb.map(vb, [this, correction1, correction2](double x, double cache) {
+        return learningRate * (x / correction1) / (std::sqrt(cache / correction2) + ADAM_EPSILON);
     });
 }
 
@@ -86,6 +110,19 @@ std::unique_ptr<Optimizer> ADAM::clone() const {
     return std::make_unique<ADAM>(this->learningRate);
 }
 
+OptimizerState ADAM::getState() const {
+    return {this->t, {this->m, this->v, this->mb, this->vb}};
+}
+
+void ADAM::setState(const OptimizerState &state) {
+    checkState(state, 4, true, "ADAM");
+    this->t = (int)state.step;
+    this->m = state.caches[0];
+    this->v = state.caches[1];
+    this->mb = state.caches[2];
+    this->vb = state.caches[3];
+}
+
 /* ADAGRAD */
 
 void ADAGRAD::updateWeights(Matrix &weights, const Matrix &gradients) const {
@@ -113,6 +150,16 @@ std::unique_ptr<Optimizer> ADAGRAD::clone() const {
     return std::make_unique<ADAGRAD>(this->learningRate);
 }
 
+OptimizerState ADAGRAD::getState() const {
+    return {0, {this->weightCache, this->biasCache}};
+}
+
+void ADAGRAD::setState(const OptimizerState &state) {
+    checkState(state, 2, false, "ADAGRAD");
+    this->weightCache = state.caches[0];
+    this->biasCache = state.caches[1];
+}
+
 /* ADADelta */
 void ADADelta::updateWeights(Matrix &weights, const Matrix &gradients) const {
     if (!this->weightGradientCache.getRowSize()) {
@@ -124,20 +171,10 @@ void ADADelta::updateWeights(Matrix &weights, const Matrix &gradients) const {
         return (ADA_DELTA_DECAY_RATE * cache) + (1 - ADA_DELTA_DECAY_RATE) * grad * grad;
     });
 
-    /* Roots Mean Squared (RMS) */
-    Matrix rmsGradient = this->weightGradientCache.map([](const double& x){
-        return std::sqrt(x + ADA_DELTA_EPSILON);
-    });
-
-    Matrix rmsUpdate = this->weightUpdateCache.map([](const double& x){
-        return std::sqrt(x + ADA_DELTA_EPSILON);
-    });
-
-    Matrix update = rmsUpdate.map(rmsGradient, [](const double& update, const double& gradient) {
-        return -update / gradient;
-    });
-
-    update = update.map(gradients, [](const double& update, const double& grad){
+    /* Roots Mean Squared (RMS) of the update over the RMS of the gradient, times the gradient */
+    const Matrix update = this->weightUpdateCache.map(this->weightGradientCache, [](const double& update, const double& gradient) {
+        return -std::sqrt(update + ADA_DELTA_EPSILON) / std::sqrt(gradient + ADA_DELTA_EPSILON);
+    }).map(gradients, [](const double& update, const double& grad){
         return update * grad;
     });
 
@@ -158,20 +195,10 @@ void ADADelta::updateBiases(Matrix &biases, const Matrix &gradients) const {
         return (ADA_DELTA_DECAY_RATE * cache) + (1 - ADA_DELTA_DECAY_RATE) * grad * grad;
     });
 
-    /* Roots Mean Squared (RMS) */
-    Matrix rmsGradient = this->biasGradientCache.map([](const double& x){
-        return std::sqrt(x + ADA_DELTA_EPSILON);
-    });
-
-    Matrix rmsUpdate = this->biasUpdateCache.map([](const double& x){
-        return std::sqrt(x + ADA_DELTA_EPSILON);
-    });
-
-    Matrix update = rmsUpdate.map(rmsGradient, [](const double& update, const double& gradient) {
-        return -update / gradient;
-    });
-
-    update = update.map(gradients, [](const double& update, const double& grad){
+    /* Roots Mean Squared (RMS) of the update over the RMS of the gradient, times the gradient */
+    const Matrix update = this->biasUpdateCache.map(this->biasGradientCache, [](const double& update, const double& gradient) {
+        return -std::sqrt(update + ADA_DELTA_EPSILON) / std::sqrt(gradient + ADA_DELTA_EPSILON);
+    }).map(gradients, [](const double& update, const double& grad){
         return update * grad;
     });
 
@@ -184,4 +211,16 @@ void ADADelta::updateBiases(Matrix &biases, const Matrix &gradients) const {
 
 std::unique_ptr<Optimizer> ADADelta::clone() const {
     return std::make_unique<ADADelta>(this->learningRate);
+}
+
+OptimizerState ADADelta::getState() const {
+    return {0, {this->weightGradientCache, this->weightUpdateCache, this->biasGradientCache, this->biasUpdateCache}};
+}
+
+void ADADelta::setState(const OptimizerState &state) {
+    checkState(state, 4, false, "ADADelta");
+    this->weightGradientCache = state.caches[0];
+    this->weightUpdateCache = state.caches[1];
+    this->biasGradientCache = state.caches[2];
+    this->biasUpdateCache = state.caches[3];
 }
\ No newline at end of file
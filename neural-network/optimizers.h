@@ -5,6 +5,8 @@
 #ifndef F1_STRATEGIES_OPTIMIZERS_H
 #define F1_STRATEGIES_OPTIMIZERS_H
 
+#include <vector>
+
 #include "./matrix.h"
 
 /* RMSPROP MACROS */
@@ -20,6 +22,11 @@
 #define ADA_DELTA_EPSILON 1e-6
 #define ADA_DELTA_DECAY_RATE 0.9
 
+/* what an optimizer accumulated during training, its caches are empty matrices until its first update */
+struct OptimizerState {
+    long step = 0;
+    std::vector<Matrix> caches;
+};
 
 class Optimizer {
 public:
@@ -31,6 +38,10 @@ public:
     virtual void updateWeights(Matrix& weights, const Matrix& gradients) const = 0;
     virtual void updateBiases(Matrix& biases, const Matrix& gradients) const = 0;
     virtual std::unique_ptr<Optimizer> clone() const = 0;
+
+    /* for checkpoints, setState throws when the state was taken from another kind of optimizer */
+    virtual OptimizerState getState() const { return {}; }
+    virtual void setState(const OptimizerState& state);
 protected:
     double learningRate;
 };
@@ -53,6 +64,8 @@ public:
     void updateWeights(Matrix &weights, const Matrix &gradients) const override;
     void updateBiases(Matrix &biases, const Matrix &gradients) const override;
     std::unique_ptr<Optimizer> clone() const override;
+    OptimizerState getState() const override;
+    void setState(const OptimizerState &state) override;
 
 private:
     mutable Matrix weightGradCache, biasGradCache;
@@ -65,6 +78,8 @@ public:
     void updateWeights(Matrix &weights, const Matrix &gradients) const override;
     void updateBiases(Matrix &biases, const Matrix &gradients) const override;
     std::unique_ptr<Optimizer> clone() const override;
+    OptimizerState getState() const override;
+    void setState(const OptimizerState &state) override;
 
 private:
     mutable int t;
@@ -78,6 +93,8 @@ public:
     void updateWeights(Matrix &weights, const Matrix &gradients) const override;
     void updateBiases(Matrix &biases, const Matrix &gradients) const override;
     std::unique_ptr<Optimizer> clone() const override;
+    OptimizerState getState() const override;
+    void setState(const OptimizerState &state) override;
 
 private:
     mutable Matrix weightCache;
@@ -91,6 +108,8 @@ public:
     void updateWeights(Matrix &weights, const Matrix &gradients) const override;
     void updateBiases(Matrix &biases, const Matrix &gradients) const override;
     std::unique_ptr<Optimizer> clone() const override;
+    OptimizerState getState() const override;
+    void setState(const OptimizerState &state) override;
 
 private:
     mutable Matrix weightGradientCache, weightUpdateCache, biasGradientCache, biasUpdateCache;
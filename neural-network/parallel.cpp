@@ -0,0 +1,41 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+void parallelFor(const size_t &count, const size_t &threadCount, const std::function<void(const size_t&)> &task) {
+    if (!count) return;
+    const size_t threads = std::clamp<size_t>(threadCount ? threadCount : std::thread::hardware_concurrency(), 1, count);
+    std::atomic<size_t> next {0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    const auto work = [&]() {
+        for (size_t i = next ++; i < count; i = next ++) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+                // the remaining tasks are skipped
+                next = count;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; t ++) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    if (error) std::rethrow_exception(error);
+}
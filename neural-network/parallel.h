@@ -0,0 +1,18 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_PARALLEL_H
+#define F1_STRATEGIES_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+/*
+ * Runs task(0) to task(count - 1) on up to threadCount threads (0 for one per core). The threads take the next
+ * index as soon as they are done with theirs, so tasks of uneven length, like trainings of different sizes,
+ * keep every thread busy. The first exception thrown by a task is rethrown once every thread is done.
+ * */
+void parallelFor(const size_t& count, const size_t& threadCount, const std::function<void(const size_t&)>& task);
+
+#endif //F1_STRATEGIES_PARALLEL_H
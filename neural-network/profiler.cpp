@@ -0,0 +1,186 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "profiler.h"
+
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Profiler::enabled {false};
+std::atomic<bool> Profiler::tracing {false};
+
+namespace {
+
+    struct PhaseStats {
+        size_t calls = 0;
+        long long totalNs = 0;
+        long long selfNs = 0;
+        size_t bytes = 0;
+    };
+
+    struct TraceEvent {
+        ProfilePhase phase;
+        int layer;
+        long long startNs;
+        long long durationNs;
+        size_t bytes;
+    };
+
+    struct ThreadProfile {
+        size_t id = 0;
+        ScopedTimer* current = nullptr;
+        // indexed by layer number + 1, so the model-wide scopes land first
+        std::vector<std::array<PhaseStats, (size_t)ProfilePhase::COUNT>> layers;
+        std::mutex eventsMutex;
+        std::vector<TraceEvent> events;
+        size_t droppedEvents = 0;
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadProfile>> registry;
+    std::atomic<long long> traceStartNs {0};
+
+    long long nanoseconds(const std::chrono::steady_clock::time_point& time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    /* the calling thread's profile, registered on first use so the trace can be written from any thread */
+    ThreadProfile& threadProfile() {
+        thread_local std::shared_ptr<ThreadProfile> profile;
+        if (!profile) {
+            profile = std::make_shared<ThreadProfile>();
+            std::lock_guard<std::mutex> lock(registryMutex);
+            profile->id = registry.size() + 1;
+            registry.push_back(profile);
+        }
+        return *profile;
+    }
+
+    std::string layerToStr(const int& layer) {
+        return layer == PROFILER_MODEL_LAYER ? "model" : "layer " + std::to_string(layer);
+    }
+
+}
+
+const char* profilePhaseToStr(const ProfilePhase& phase) {
+    switch (phase) {
+        case ProfilePhase::FORWARD_FEED: return "forward-feed";
+        case ProfilePhase::CALCULATE_DELS: return "calculate-dels";
+        case ProfilePhase::GRADIENT_DESCENT: return "gradient-descent";
+        case ProfilePhase::OPTIMIZER: return "optimizer";
+        case ProfilePhase::LOSS: return "loss";
+        default: return "unknown";
+    }
+}
+
+/* Profiler */
+
+void Profiler::enable(const bool &enabled, const bool &trace) {
+    if (trace && !Profiler::tracing) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const std::shared_ptr<ThreadProfile>& profile : registry) {
+            std::lock_guard<std::mutex> eventsLock(profile->eventsMutex);
+            profile->events.clear();
+            profile->droppedEvents = 0;
+        }
+        traceStartNs = nanoseconds(std::chrono::steady_clock::now());
+    }
+    Profiler::tracing = enabled && trace;
+    Profiler::enabled = enabled;
+}
+
+void Profiler::recordAllocation(const size_t &bytes) {
+    ScopedTimer* current = threadProfile().current;
+    if (current) current->bytes += bytes;
+}
+
+void Profiler::printSummary(std::ostream &o) {
+    ThreadProfile& profile = threadProfile();
+    const std::ios_base::fmtflags flags = o.flags();
+    const std::streamsize precision = o.precision();
+    o << std::fixed << std::setprecision(3);
+    for (size_t phase = 0; phase < (size_t)ProfilePhase::COUNT; phase ++) {
+        for (size_t layer = 0; layer < profile.layers.size(); layer ++) {
+            const PhaseStats& stats = profile.layers[layer][phase];
+            if (!stats.calls) continue;
+            o << "    " << std::left << std::setw(18) << profilePhaseToStr((ProfilePhase)phase) << std::setw(10)
+              << layerToStr((int)layer - 1) << std::right << std::setw(10) << stats.calls << " calls"
+              << std::setw(12) << (double)stats.totalNs / 1e6 << " ms total" << std::setw(12) << (double)stats.selfNs / 1e6
+              << " ms self" << std::setw(12) << (double)stats.bytes / (1024. * 1024.) << " MB allocated" << std::endl;
+        }
+    }
+    o.flags(flags);
+    o.precision(precision);
+    profile.layers.clear();
+}
+
+void Profiler::writeTrace(const std::string &path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file!" << std::endl;
+        return;
+    }
+    file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+    bool first = true;
+    size_t dropped = 0;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::shared_ptr<ThreadProfile>& profile : registry) {
+        std::lock_guard<std::mutex> eventsLock(profile->eventsMutex);
+        dropped += profile->droppedEvents;
+        file << (first ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << profile->id
+             << R"(,"args":{"name":"thread )" << profile->id << "\"}}";
+        first = false;
+        for (const TraceEvent& event : profile->events) {
+            // timestamps are in microseconds
+            file << ",\n{\"name\":\"" << profilePhaseToStr(event.phase) << " (" << layerToStr(event.layer) << ")\",\"cat\":\""
+                 << profilePhaseToStr(event.phase) << R"(","ph":"X","ts":)" << (double)event.startNs / 1e3
+                 << ",\"dur\":" << (double)event.durationNs / 1e3 << ",\"pid\":1,\"tid\":" << profile->id
+                 << ",\"args\":{\"layer\":" << event.layer << ",\"bytes\":" << event.bytes << "}}";
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+}
+
+/* Scoped timer */
+
+ScopedTimer::ScopedTimer(const ProfilePhase &phase, const int &layer) : active(Profiler::isEnabled()), phase(phase), layer(layer) {
+    if (!this->active) return;
+    ThreadProfile& profile = threadProfile();
+    this->parent = profile.current;
+    profile.current = this;
+    this->start = std::chrono::steady_clock::now();
+}
+
+ScopedTimer::~ScopedTimer() {
+    if (!this->active) return;
+    const auto end = std::chrono::steady_clock::now();
+    const long long durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - this->start).count();
+    ThreadProfile& profile = threadProfile();
+    profile.current = this->parent;
+
+    const size_t index = (size_t)(this->layer - PROFILER_MODEL_LAYER);
+    if (profile.layers.size() <= index) profile.layers.resize(index + 1);
+    PhaseStats& stats = profile.layers[index][(size_t)this->phase];
+    stats.calls ++;
+    stats.totalNs += durationNs;
+    stats.selfNs += durationNs - this->childrenNs;
+    stats.bytes += this->bytes;
+    // the parent's time and allocations include this scope's
+    if (this->parent) {
+        this->parent->childrenNs += durationNs;
+        this->parent->bytes += this->bytes;
+    }
+
+    if (Profiler::tracing.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(profile.eventsMutex);
+        if (profile.events.size() < PROFILER_MAX_TRACE_EVENTS)
+            profile.events.push_back({this->phase, this->layer, nanoseconds(this->start) - traceStartNs, durationNs, this->bytes});
+        else profile.droppedEvents ++;
+    }
+}
@@ -0,0 +1,72 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_PROFILER_H
+#define F1_STRATEGIES_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+/* PROFILER MACROS */
+#define PROFILER_MAX_TRACE_EVENTS 2000000   // per thread, later events are counted but dropped
+#define PROFILER_MODEL_LAYER -1             // scopes that aren't tied to a layer
+
+/*
+ * Scoped timers compiled into the training hot paths. They cost one relaxed atomic load while the profiler is
+ * disabled. Once enabled, every scope records its calls, its inclusive and self time and the bytes of the
+ * matrices allocated while it is active, per phase and per layer. Trainings print the calling thread's
+ * statistics after each "Loss at Epoch" line and reset them. With tracing on, every scope is also kept as a
+ * complete event of the Chrome trace format, which chrome://tracing, Perfetto or speedscope show as a
+ * flamegraph.
+ *
+ * Statistics are kept per thread, so models trained concurrently don't mix their summaries.
+ * */
+
+enum class ProfilePhase { FORWARD_FEED, CALCULATE_DELS, GRADIENT_DESCENT, OPTIMIZER, LOSS, COUNT };
+
+const char* profilePhaseToStr(const ProfilePhase& phase);
+
+class Profiler {
+public:
+    static void enable(const bool& enabled, const bool& trace = false);
+    static bool isEnabled() { return Profiler::enabled.load(std::memory_order_relaxed); }
+
+    /* called by Matrix for every buffer it allocates */
+    static void allocated(const size_t& bytes) { if (Profiler::isEnabled()) Profiler::recordAllocation(bytes); }
+
+    /* prints and resets the statistics recorded by the calling thread */
+    static void printSummary(std::ostream& o);
+    /* writes the events of every thread since tracing was enabled */
+    static void writeTrace(const std::string& path);
+
+private:
+    friend class ScopedTimer;
+    static void recordAllocation(const size_t& bytes);
+
+    static std::atomic<bool> enabled;
+    static std::atomic<bool> tracing;
+};
+
+class ScopedTimer {
+public:
+    ScopedTimer(const ProfilePhase& phase, const int& layer);
+    ~ScopedTimer();
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator = (const ScopedTimer&) = delete;
+
+private:
+    friend class Profiler;
+    bool active;
+    ProfilePhase phase;
+    int layer;
+    std::chrono::steady_clock::time_point start;
+    long long childrenNs = 0;
+    size_t bytes = 0;
+    ScopedTimer* parent = nullptr;
+};
+
+#endif //F1_STRATEGIES_PROFILER_H
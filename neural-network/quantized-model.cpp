@@ -0,0 +1,315 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "quantized-model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_FEATURE_DOTPROD)
+#include <arm_neon.h>
+#endif
+
+/* Utility functions */
+int8_t quantize(const double& value, const float& scale) {
+    const long level = std::lround(value / scale);
+    return static_cast<int8_t>(std::clamp(level, (long)-QUANTIZATION_LEVELS, (long)QUANTIZATION_LEVELS));
+}
+
+float scaleFor(const double& maxAbsValue) {
+    // an all-zero tensor quantizes to zeros whatever the scale, 1 avoids dividing by 0
+    return maxAbsValue > 0 ? static_cast<float>(maxAbsValue / QUANTIZATION_LEVELS) : 1.f;
+}
+
+/* quantize over size values, first rounded to floats */
+void quantizeRow(const double* values, int8_t* quantized, const size_t& size, const float& scale) {
+    size_t k = 0;
+#if defined(__AVX2__)
+    // rounds halves to even where lround rounds them away from zero, only exact halves can differ
+    const __m256d divisor = _mm256_set1_pd(scale);
+    const __m256d highest = _mm256_set1_pd(QUANTIZATION_LEVELS), lowest = _mm256_set1_pd(-QUANTIZATION_LEVELS);
+    for (; k + 4 <= size; k += 4) {
+        const __m256d rounded = _mm256_cvtps_pd(_mm256_cvtpd_ps(_mm256_loadu_pd(values + k)));
+        const __m256d levels = _mm256_min_pd(_mm256_max_pd(_mm256_div_pd(rounded, divisor), lowest), highest);
+        const __m128i words = _mm_packs_epi32(_mm256_cvtpd_epi32(levels), _mm_setzero_si128());
+        const int32_t bytes = _mm_cvtsi128_si32(_mm_packs_epi16(words, _mm_setzero_si128()));
+        std::memcpy(quantized + k, &bytes, sizeof(bytes));
+    }
+#endif
+    for (; k < size; k ++) {
+        quantized[k] = quantize(static_cast<float>(values[k]), scale);
+    }
+}
+
+size_t paddedSize(const size_t& size) {
+    return (size + QUANTIZATION_ROW_ALIGNMENT - 1) / QUANTIZATION_ROW_ALIGNMENT * QUANTIZATION_ROW_ALIGNMENT;
+}
+
+QuantizedModel::QuantizedModel(const Model& model, const std::vector<Matrix>& calibrationX, const size_t& sampleCount) {
+    if (calibrationX.empty())
+        throw std::invalid_argument("Calibration data shouldn't be empty!");
+
+    std::shared_ptr<Layer> layer = model.getInputLayer();
+    while (layer) {
+        const Matrix weights = layer->getWeight();
+        const Matrix biases = layer->getBiases();
+        QuantizedLayer quantizedLayer;
+        quantizedLayer.neuronCount = weights.getRowSize();
+        quantizedLayer.inputCount = weights.getColumnSize();
+        quantizedLayer.paddedInputCount = paddedSize(quantizedLayer.inputCount);
+        quantizedLayer.activation = layer->getActivation();
+
+        double maxAbsWeight = 0.;
+        for (size_t i = 0; i < quantizedLayer.neuronCount; i ++) {
+            for (size_t k = 0; k < quantizedLayer.inputCount; k ++) {
+                maxAbsWeight = std::max(maxAbsWeight, std::abs(weights(i, k)));
+            }
+        }
+        quantizedLayer.weightScale = scaleFor(maxAbsWeight);
+        quantizedLayer.weights.assign(quantizedLayer.neuronCount * quantizedLayer.paddedInputCount, 0);
+        for (size_t i = 0; i < quantizedLayer.neuronCount; i ++) {
+            for (size_t k = 0; k < quantizedLayer.inputCount; k ++) {
+                quantizedLayer.weights[i * quantizedLayer.paddedInputCount + k] = quantize(weights(i, k), quantizedLayer.weightScale);
+            }
+            quantizedLayer.biases.push_back(static_cast<float>(biases(i, 0)));
+        }
+        this->layers.push_back(std::move(quantizedLayer));
+        layer = layer->getNextLayer();
+    }
+
+    /* Calibration: the input scale of every layer covers the largest value it sees on an evenly spaced sample */
+    std::vector<double> maxAbsInputs(this->layers.size(), 0.);
+    const size_t step = std::max<size_t>(1, calibrationX.size() / std::max<size_t>(1, sampleCount));
+    for (size_t s = 0; s < calibrationX.size(); s += step) {
+        Matrix activations = calibrationX[s];
+        std::shared_ptr<Layer> currentLayer = model.getInputLayer();
+        for (size_t l = 0; l < this->layers.size(); l ++) {
+            for (size_t i = 0; i < activations.getRowSize(); i ++) {
+                maxAbsInputs[l] = std::max(maxAbsInputs[l], std::abs(activations(i, 0)));
+            }
+            activations = currentLayer->output(activations);
+            currentLayer = currentLayer->getNextLayer();
+        }
+    }
+    for (size_t l = 0; l < this->layers.size(); l ++) {
+        this->layers[l].inputScale = scaleFor(maxAbsInputs[l]);
+    }
+}
+
+Matrix QuantizedModel::predict(const Matrix &input) const {
+    if (input.getRowSize() != this->layers.front().inputCount || input.getColumnSize() != 1)
+        throw std::invalid_argument("Input must be a vector of the model's input size!");
+    return this->predictBatch(input);
+}
+
+Matrix QuantizedModel::predictBatch(const Matrix &inputs) const {
+    if (inputs.getRowSize() != this->layers.front().inputCount || inputs.getColumnSize() == 0)
+        throw std::invalid_argument("Inputs must be columns of the model's input size!");
+
+    // kept from one call to the next, predict runs on several threads at once (see predict.cpp); every buffer
+    // holds one row per sample
+    thread_local std::vector<double> values;
+    thread_local std::vector<int8_t> quantizedValues;
+    thread_local std::vector<int32_t> products;
+    const size_t samples = inputs.getColumnSize();
+    size_t width = inputs.getRowSize();
+    values.resize(samples * width);
+    for (size_t s = 0; s < samples; s ++) {
+        for (size_t k = 0; k < width; k ++) {
+            values[s * width + k] = static_cast<float>(inputs(k, s));
+        }
+    }
+
+    for (const QuantizedLayer& layer : this->layers) {
+        quantizedValues.assign(samples * layer.paddedInputCount, 0);
+        for (size_t s = 0; s < samples; s ++) {
+            quantizeRow(&values[s * width], &quantizedValues[s * layer.paddedInputCount], layer.inputCount, layer.inputScale);
+        }
+        products.resize(samples * layer.neuronCount);
+        QuantizedModel::multiply(layer, quantizedValues.data(), samples, products.data());
+
+        const float scale = layer.weightScale * layer.inputScale;
+        width = layer.neuronCount;
+        values.resize(samples * width);
+        for (size_t s = 0; s < samples; s ++) {
+            for (size_t i = 0; i < width; i ++) {
+                values[s * width + i] = products[s * width + i] * scale + layer.biases[i];
+            }
+        }
+        layer.activation->applyBatch(values.data(), values.data(), values.size());
+    }
+
+    Matrix::Rows result = Matrix::allocateRows(width, samples);
+    for (size_t i = 0; i < width; i ++) {
+        for (size_t s = 0; s < samples; s ++) {
+            result[i][s] = static_cast<float>(values[s * width + i]);
+        }
+    }
+    return Matrix(std::move(result));
+}
+
+void QuantizedModel::multiply(const QuantizedLayer &layer, const int8_t *inputs, const size_t &samples, int32_t *products) {
+    const size_t size = layer.paddedInputCount;
+    size_t s = 0;
+#if defined(__AVX2__)
+    /*
+     * Blocks of 4 samples, widened to int16 once per block: every 16 weights of a row are widened once and
+     * multiplied against the 4 samples, each summing into its own int32 accumulator.
+     * */
+    thread_local std::vector<int16_t> widened;
+    widened.resize(4 * size);
+    for (; s + 4 <= samples; s += 4) {
+        for (size_t k = 0; k < 4 * size; k ++) {
+            widened[k] = inputs[s * size + k];
+        }
+        const int16_t* x = widened.data();
+        for (size_t i = 0; i < layer.neuronCount; i ++) {
+            const int8_t* w = &layer.weights[i * size];
+            __m256i a0 = _mm256_setzero_si256(), a1 = _mm256_setzero_si256(), a2 = _mm256_setzero_si256(), a3 = _mm256_setzero_si256();
+            for (size_t k = 0; k < size; k += 16) {
+                const __m256i weights = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w + k)));
+                a0 = _mm256_add_epi32(a0, _mm256_madd_epi16(weights, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + k))));
+                a1 = _mm256_add_epi32(a1, _mm256_madd_epi16(weights, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + size + k))));
+                a2 = _mm256_add_epi32(a2, _mm256_madd_epi16(weights, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + 2 * size + k))));
+                a3 = _mm256_add_epi32(a3, _mm256_madd_epi16(weights, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + 3 * size + k))));
+            }
+            // lane j of the sum is the dot product of sample j
+            const __m256i sums = _mm256_hadd_epi32(_mm256_hadd_epi32(a0, a1), _mm256_hadd_epi32(a2, a3));
+            const __m128i dots = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+            products[s * layer.neuronCount + i] = _mm_extract_epi32(dots, 0);
+            products[(s + 1) * layer.neuronCount + i] = _mm_extract_epi32(dots, 1);
+            products[(s + 2) * layer.neuronCount + i] = _mm_extract_epi32(dots, 2);
+            products[(s + 3) * layer.neuronCount + i] = _mm_extract_epi32(dots, 3);
+        }
+    }
+#endif
+    for (; s < samples; s ++) {
+        for (size_t i = 0; i < layer.neuronCount; i ++) {
+            products[s * layer.neuronCount + i] = QuantizedModel::dot(&layer.weights[i * size], inputs + s * size, size);
+        }
+    }
+}
+
+int32_t QuantizedModel::dot(const int8_t* a, const int8_t* b, const size_t& size) {
+    /* size is a multiple of QUANTIZATION_ROW_ALIGNMENT */
+#if defined(__AVX2__)
+    __m256i accumulated = _mm256_setzero_si256();
+    for (size_t i = 0; i < size; i += 16) {
+        const __m256i x = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        const __m256i y = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        accumulated = _mm256_add_epi32(accumulated, _mm256_madd_epi16(x, y));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(accumulated), _mm256_extracti128_si256(accumulated, 1));
+    sum = _mm_hadd_epi32(sum, sum);
+    sum = _mm_hadd_epi32(sum, sum);
+    return _mm_cvtsi128_si32(sum);
+#elif defined(__ARM_FEATURE_DOTPROD)
+    int32x4_t accumulated = vdupq_n_s32(0);
+    for (size_t i = 0; i < size; i += 16) {
+        accumulated = vdotq_s32(accumulated, vld1q_s8(a + i), vld1q_s8(b + i));
+    }
+    return vaddvq_s32(accumulated);
+#else
+    int32_t accumulated = 0;
+    for (size_t i = 0; i < size; i ++) {
+        accumulated += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+    }
+    return accumulated;
+#endif
+}
+
+void QuantizedModel::save(const std::string &filePath) const {
+    std::ofstream file;
+    file.open("../quantized_" + filePath);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file!" << std::endl;
+        return;
+    }
+    file << std::setprecision(std::numeric_limits<float>::max_digits10);
+    for (size_t l = 0; l < this->layers.size(); l ++) {
+        const QuantizedLayer& layer = this->layers[l];
+        file << "Layer #" << l << ":\n";
+        file << "Scales: " << layer.weightScale << " " << layer.inputScale << "\n";
+        file << "[";
+        for (size_t i = 0; i < layer.neuronCount; i ++) {
+            file << "[";
+            for (size_t k = 0; k < layer.inputCount; k ++) {
+                file << (int)layer.weights[i * layer.paddedInputCount + k] << (k + 1 != layer.inputCount ? ", " : "");
+            }
+            file << "]" << (i + 1 != layer.neuronCount ? ",\n" : "");
+        }
+        file << "]\n\n";
+    }
+    file.close();
+}
+
+std::unique_ptr<QuantizedModel> QuantizedModel::importModel(const std::string &filePath) {
+    // the float model files still hold the topology, biases and activations
+    const std::unique_ptr<Model> model = Model::importModel(filePath);
+    std::unique_ptr<QuantizedModel> quantizedModel(new QuantizedModel());
+
+    const std::string path = "../quantized_" + filePath;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::invalid_argument("Couldn't open file \"" + path + "\"\n");
+    }
+    std::string line;
+    std::vector<std::vector<int>> rows;
+    float weightScale = 1.f, inputScale = 1.f;
+    std::shared_ptr<Layer> layer = model->getInputLayer();
+    while (std::getline(file, line)) {
+        if (line.starts_with("Scales:")) {
+            std::istringstream(line.substr(7)) >> weightScale >> inputScale;
+            continue;
+        }
+        if (line.empty() || line[0] != '[') continue;
+        const bool isClosingMatrix = line.ends_with("]]");
+        std::replace_if(line.begin(), line.end(), [](char c) { return c == '[' || c == ']' || c == ','; }, ' ');
+        std::istringstream iss(line);
+        rows.emplace_back(std::istream_iterator<int>(iss), std::istream_iterator<int>());
+        if (!isClosingMatrix) continue;
+
+        if (!layer)
+            throw std::invalid_argument("\"" + path + "\" has more layers than the model.");
+        const Matrix biases = layer->getBiases();
+        const size_t columns = layer->getWeight().getColumnSize();
+        if (rows.size() != layer->getWeight().getRowSize() || std::any_of(rows.begin(), rows.end(), [&columns](const std::vector<int>& row) {
+                return row.size() != columns;
+            }))
+            throw std::invalid_argument("\"" + path + "\" doesn't match the model's topology.");
+        for (const std::vector<int>& row : rows) {
+            if (std::any_of(row.begin(), row.end(), [](const int& weight) { return std::abs(weight) > QUANTIZATION_LEVELS; }))
+                throw std::invalid_argument("\"" + path + "\" has weights outside of the int8 range.");
+        }
+
+        QuantizedLayer quantizedLayer;
+        quantizedLayer.neuronCount = rows.size();
+        quantizedLayer.inputCount = rows[0].size();
+        quantizedLayer.paddedInputCount = paddedSize(quantizedLayer.inputCount);
+        quantizedLayer.weightScale = weightScale;
+        quantizedLayer.inputScale = inputScale;
+        quantizedLayer.activation = layer->getActivation();
+        quantizedLayer.weights.assign(quantizedLayer.neuronCount * quantizedLayer.paddedInputCount, 0);
+        for (size_t i = 0; i < quantizedLayer.neuronCount; i ++) {
+            for (size_t k = 0; k < quantizedLayer.inputCount; k ++) {
+                quantizedLayer.weights[i * quantizedLayer.paddedInputCount + k] = static_cast<int8_t>(rows[i][k]);
+            }
+            quantizedLayer.biases.push_back(static_cast<float>(biases(i, 0)));
+        }
+        quantizedModel->layers.push_back(std::move(quantizedLayer));
+        rows.clear();
+        layer = layer->getNextLayer();
+    }
+    if (quantizedModel->layers.empty() || layer)
+        throw std::invalid_argument("\"" + path + "\" doesn't match the model's topology.");
+    return quantizedModel;
+}
@@ -0,0 +1,64 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_QUANTIZED_MODEL_H
+#define F1_STRATEGIES_QUANTIZED_MODEL_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model.h"
+
+/* QUANTIZATION MACROS */
+#define QUANTIZATION_LEVELS 127           // symmetric int8 range, [-127, 127]
+#define QUANTIZATION_ROW_ALIGNMENT 16     // int8 rows are zero padded to a multiple of one SIMD register
+#define QUANTIZATION_CALIBRATION_SAMPLES 512
+
+/*
+ * Post-training int8 version of a Model, for inference only. Every layer keeps one scale for its weights
+ * and one for its inputs (calibrated on sample data), the products are accumulated as int8 x int8 -> int32
+ * and converted back to floats before the bias and the activation are applied, the activation once per layer
+ * over the whole buffer. A batch goes through every layer as one int8 matrix product, see multiply.
+ * */
+class QuantizedModel {
+public:
+    static std::unique_ptr<QuantizedModel> importModel(const std::string& filePath);
+
+    QuantizedModel(const Model& model, const std::vector<Matrix>& calibrationX, const size_t& sampleCount);
+    ~QuantizedModel() = default;
+
+    Matrix predict(const Matrix& input) const;
+    /* one sample per column, like Model::predictBatch */
+    Matrix predictBatch(const Matrix& inputs) const;
+
+    /*
+     * writes the int8 weights and scales to ../quantized_<filePath>, beside the float model files (see Model::save),
+     * which importModel reads back for the topology, biases and activations
+     * */
+    void save(const std::string& filePath) const;
+
+private:
+    struct QuantizedLayer {
+        size_t neuronCount;
+        size_t inputCount;
+        size_t paddedInputCount;
+        float weightScale;
+        float inputScale;
+        std::vector<int8_t> weights;    // neuronCount x paddedInputCount, row major
+        std::vector<float> biases;
+        std::shared_ptr<ActivationFunction> activation;
+    };
+
+    QuantizedModel() = default;
+
+    static int32_t dot(const int8_t* a, const int8_t* b, const size_t& size);
+    /* products[s x neuronCount + i] = row i of the weights . row s of the inputs, both paddedInputCount long */
+    static void multiply(const QuantizedLayer& layer, const int8_t* inputs, const size_t& samples, int32_t* products);
+
+    std::vector<QuantizedLayer> layers;
+};
+
+#endif //F1_STRATEGIES_QUANTIZED_MODEL_H
@@ -0,0 +1,192 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_STATIC_MODEL_H
+#define F1_STRATEGIES_STATIC_MODEL_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "model.h"
+
+/*
+ * Compile-time counterparts of the activation functions. They compute exactly what the lambdas in
+ * activation-functions.cpp compute, so a StaticModel stays bit-comparable with Model::predict. matches only
+ * accepts the dynamic activation computing the same function: same alpha, and not the fast-math approximation.
+ * */
+struct StaticNoActivation {
+    static double function(const double& x) { return x; }
+    static bool matches(const ActivationFunction& f) { return dynamic_cast<const NoActivation*>(&f); }
+};
+
+struct StaticReLU {
+    static double function(const double& x) { return std::max(0.0, x); }
+    static bool matches(const ActivationFunction& f) { return dynamic_cast<const ReLU*>(&f); }
+};
+
+template <double Alpha>
+struct StaticLeakyReLU {
+    static double function(const double& x) { return x >= 0 ? x : Alpha * x; }
+    static bool matches(const ActivationFunction& f) {
+        const auto* leakyReLU = dynamic_cast<const LeakyReLU*>(&f);
+        return leakyReLU && leakyReLU->getAlpha() == Alpha;
+    }
+};
+
+template <double Alpha>
+struct StaticELU {
+    static double function(const double& x) { return x >= 0 ? x : Alpha * (std::exp(x) - 1); }
+    static bool matches(const ActivationFunction& f) {
+        const auto* elu = dynamic_cast<const ELU*>(&f);
+        return elu && elu->getAlpha() == Alpha && !elu->isApproximate();
+    }
+};
+
+struct StaticTanH {
+    static double function(const double& x) { return std::tanh(x); }
+    static bool matches(const ActivationFunction& f) {
+        const auto* tanh = dynamic_cast<const TanH*>(&f);
+        return tanh && !tanh->isApproximate();
+    }
+};
+
+struct StaticSigmoid {
+    static double function(const double& x) { return 1 / (1 + std::exp(-x)); }
+    static bool matches(const ActivationFunction& f) {
+        const auto* sigmoid = dynamic_cast<const Sigmoid*>(&f);
+        return sigmoid && !sigmoid->isApproximate();
+    }
+};
+
+/*
+ * A fully connected layer whose shape and activation are known at compile time. The weights are stored
+ * transposed (one row per input) so the inner loop walks all the neurons contiguously, which the compiler
+ * can vectorise without reordering any neuron's own sum.
+ * */
+template <size_t Inputs, size_t Neurons, typename Activation>
+class StaticLayer {
+public:
+    static constexpr size_t inputs = Inputs;
+    static constexpr size_t neurons = Neurons;
+
+    void load(Layer& layer) {
+        const Matrix weights = layer.getWeight();
+        const Matrix biases = layer.getBiases();
+        if (weights.getRowSize() != Neurons || weights.getColumnSize() != Inputs || biases.getRowSize() != Neurons) {
+            std::ostringstream oss;
+            oss << "Layer #" << layer.getLayerNumber() << " is " << weights.getRowSize() << "x" << weights.getColumnSize()
+                << ", expected " << Neurons << "x" << Inputs << ".";
+            throw std::invalid_argument(oss.str());
+        }
+        if (!Activation::matches(*layer.getActivation())) {
+            std::ostringstream oss;
+            oss << "Layer #" << layer.getLayerNumber() << " uses " << *layer.getActivation() << ", which doesn't match the static activation.";
+            throw std::invalid_argument(oss.str());
+        }
+        for (size_t i = 0; i < Neurons; i ++) {
+            for (size_t k = 0; k < Inputs; k ++) {
+                this->weights[k][i] = weights(i, k);
+            }
+            this->biases[i] = biases(i, 0);
+        }
+    }
+
+    void output(const std::array<double, Inputs>& input, std::array<double, Neurons>& result) const {
+        // same accumulation order as Matrix::multCPU followed by the bias addition
+        result.fill(0.);
+        for (size_t k = 0; k < Inputs; k ++) {
+            for (size_t i = 0; i < Neurons; i ++) {
+                result[i] += this->weights[k][i] * input[k];
+            }
+        }
+        for (size_t i = 0; i < Neurons; i ++) {
+            result[i] = Activation::function(result[i] + this->biases[i]);
+        }
+    }
+
+private:
+    alignas(64) std::array<std::array<double, Neurons>, Inputs> weights {};
+    alignas(64) std::array<double, Neurons> biases {};
+};
+
+/*
+ * Inference-only network with a fixed topology, built from a trained Model. The first layer is the
+ * model's input layer (identity weights, null biases, but still an activation), so a 14 -> 64 -> 3
+ * Model is a StaticModel<StaticLayer<14, 14, A>, StaticLayer<14, 64, A>, StaticLayer<64, 3, A>>.
+ * */
+template <typename... Layers>
+class StaticModel {
+    using FirstLayer = std::tuple_element_t<0, std::tuple<Layers...>>;
+    using LastLayer = std::tuple_element_t<sizeof...(Layers) - 1, std::tuple<Layers...>>;
+
+public:
+    static constexpr size_t inputs = FirstLayer::inputs;
+    static constexpr size_t outputs = LastLayer::neurons;
+
+    static std::unique_ptr<StaticModel> fromModel(const Model& model) {
+        auto staticModel = std::make_unique<StaticModel>();
+        std::shared_ptr<Layer> currentLayer = model.getInputLayer();
+        std::apply([&currentLayer](auto&... layers) {
+            ((StaticModel::loadLayer(layers, currentLayer)), ...);
+        }, staticModel->layers);
+        if (currentLayer)
+            throw std::invalid_argument("The model has more layers than the static topology.");
+        return staticModel;
+    }
+
+    std::array<double, outputs> predict(const std::array<double, inputs>& input) const {
+        return this->forwardFeed<0>(input);
+    }
+
+    Matrix predict(const Matrix& input) const {
+        if (input.getRowSize() != inputs || input.getColumnSize() != 1)
+            throw std::invalid_argument("Input must be a vector of the model's input size!");
+        std::array<double, inputs> values;
+        for (size_t i = 0; i < inputs; i ++) {
+            values[i] = input(i, 0);
+        }
+        const std::array<double, outputs> result = this->predict(values);
+        std::vector<std::unique_ptr<std::vector<double>>> data(outputs);
+        for (size_t i = 0; i < outputs; i ++) {
+            data[i] = std::make_unique<std::vector<double>>(1, result[i]);
+        }
+        return Matrix(std::move(data));
+    }
+
+private:
+    template <typename L>
+    static void loadLayer(L& layer, std::shared_ptr<Layer>& currentLayer) {
+        if (!currentLayer)
+            throw std::invalid_argument("The model has fewer layers than the static topology.");
+        layer.load(*currentLayer);
+        currentLayer = currentLayer->getNextLayer();
+    }
+
+    template <size_t Index>
+    auto forwardFeed(const std::array<double, std::tuple_element_t<Index, std::tuple<Layers...>>::inputs>& input) const {
+        using L = std::tuple_element_t<Index, std::tuple<Layers...>>;
+        std::array<double, L::neurons> result;
+        std::get<Index>(this->layers).output(input, result);
+        if constexpr (Index + 1 < sizeof...(Layers)) return this->forwardFeed<Index + 1>(result);
+        else return result;
+    }
+
+    std::tuple<Layers...> layers;
+};
+
+/* Production tyre-decay topology, see main.cpp */
+using TyreDecayModel = StaticModel<StaticLayer<14, 14, StaticTanH>,
+                                   StaticLayer<14, 64, StaticTanH>,
+                                   StaticLayer<64, 64, StaticTanH>,
+                                   StaticLayer<64, 9, StaticTanH>,
+                                   StaticLayer<9, 3, StaticTanH>>;
+
+#endif //F1_STRATEGIES_STATIC_MODEL_H
@@ -4,6 +4,10 @@
 
 #include "visitor.h"
 
+#include <cctype>
+#include <iomanip>
+#include <limits>
+
 std::vector<float> readMatrixLine(const std::string& s) {
     std::vector<float> result = {};
     std::istringstream iss(s);
@@ -31,6 +35,10 @@ double findAlpha(const std::string& s) {
     return std::stof(s.substr(pos + 1));
 }
 
+bool isApproximate(const std::string& s) {
+    return s.find("approximate") != std::string::npos;
+}
+
 std::shared_ptr<ActivationFunction> readActivationType(const std::string& s) {
     if (s.starts_with("NoActivation"))
         return std::make_shared<NoActivation>();
@@ -41,17 +49,48 @@ std::shared_ptr<ActivationFunction> readActivationType(const std::string& s) {
         return std::make_shared<LeakyReLU>(alpha);
     } else if (s.starts_with("ELU")) {
         double alpha = findAlpha(s);
-        return std::make_shared<ELU>(alpha);
+        return std::make_shared<ELU>(alpha, isApproximate(s));
     }
     else if (s.starts_with("TanH")) {
         double alpha = findAlpha(s);
-        return std::make_shared<TanH>(alpha);
+        return std::make_shared<TanH>(alpha, isApproximate(s));
     } else if (s.starts_with("Sigmoid")) {
-        return std::make_shared<Sigmoid>();
+        return std::make_shared<Sigmoid>(isApproximate(s));
     }
     return nullptr;
 }
 
+std::string floatLiteral(const double& value) {
+    std::ostringstream oss;
+    oss << std::setprecision(std::numeric_limits<float>::max_digits10) << static_cast<float>(value);
+    std::string literal = oss.str();
+    if (literal.find_first_of(".e") == std::string::npos) literal += ".";
+    return literal + "f";
+}
+
+std::string activationToCpp(const ActivationFunction& f) {
+    /* C++ expression of the activation applied to a float named x, mirrors readActivationType */
+    std::ostringstream oss;
+    oss << f;
+    const std::string s = oss.str();
+    // the header computes with std:: functions, which the fast-math approximations only match to 1e-8
+    if (isApproximate(s))
+        throw std::invalid_argument("Can't export the approximate activation \"" + s + "\" to C++, export the exact one instead");
+    if (s.starts_with("NoActivation"))
+        return "x";
+    else if (s.starts_with("ReLU"))
+        return "std::max(0.f, x)";
+    else if (s.starts_with("LeakyReLU"))
+        return "x >= 0 ? x : " + floatLiteral(findAlpha(s)) + " * x";
+    else if (s.starts_with("ELU"))
+        return "x >= 0 ? x : " + floatLiteral(findAlpha(s)) + " * (std::exp(x) - 1)";
+    else if (s.starts_with("TanH"))
+        return "std::tanh(x)";
+    else if (s.starts_with("Sigmoid"))
+        return "1 / (1 + std::exp(-x))";
+    throw std::invalid_argument("Can't export activation \"" + s + "\" to C++");
+}
+
 /* Export */
 void ExportVisitor::doSomethingWithWeight(Model * model) {
     this->exportModel(ExportImportTypes::WEIGHTS, model);
@@ -186,4 +225,90 @@ std::vector<std::shared_ptr<ActivationFunction>> ImportVisitor::importActivation
         result.push_back(readActivationType(line));
     }
     return result;
-}
\ No newline at end of file
+}
+
+/* Header export */
+
+void HeaderExportVisitor::doSomethingWithWeight(Model *model) {
+    std::shared_ptr<Layer> layer = model->getInputLayer();
+    while (layer) {
+        // stored input-major so the generated loops walk the neurons contiguously
+        const Matrix weights = layer->getWeight();
+        this->_arrays << "// Layer #" << layer->getLayerNumber() << ": " << weights.getRowSize() << " neurons, "
+                      << weights.getColumnSize() << " inputs\n"
+                      << "alignas(64) inline constexpr float layer" << layer->getLayerNumber() << "Weights["
+                      << weights.getColumnSize() << "][" << weights.getRowSize() << "] = {\n";
+        for (size_t k = 0; k < weights.getColumnSize(); k ++) {
+            this->_arrays << "    {";
+            for (size_t i = 0; i < weights.getRowSize(); i ++) {
+                this->_arrays << floatLiteral(weights(i, k)) << (i + 1 != weights.getRowSize() ? ", " : "");
+            }
+            this->_arrays << "},\n";
+        }
+        this->_arrays << "};\n\n";
+        layer = layer->getNextLayer();
+    }
+}
+
+void HeaderExportVisitor::doSomethingWithBias(Model *model) {
+    std::shared_ptr<Layer> layer = model->getInputLayer();
+    while (layer) {
+        const Matrix biases = layer->getBiases();
+        this->_arrays << "alignas(64) inline constexpr float layer" << layer->getLayerNumber() << "Biases["
+                      << biases.getRowSize() << "] = {";
+        for (size_t i = 0; i < biases.getRowSize(); i ++) {
+            this->_arrays << floatLiteral(biases(i, 0)) << (i + 1 != biases.getRowSize() ? ", " : "");
+        }
+        this->_arrays << "};\n\n";
+        layer = layer->getNextLayer();
+    }
+}
+
+void HeaderExportVisitor::doSomethingWithActivations(Model *model) {
+    std::ofstream file;
+    file.open("../" + this->_path);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file!" << std::endl;
+        return;
+    }
+    std::string guard = this->_name + "_H";
+    std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
+
+    std::ostringstream body;
+    std::shared_ptr<Layer> layer = model->getInputLayer();
+    std::string input = "input";
+    size_t inputCount = layer->getWeight().getColumnSize(), outputCount = 0;
+    while (layer) {
+        const std::string n = std::to_string(layer->getLayerNumber());
+        const std::string neurons = std::to_string(layer->getNeuronCount());
+        const std::string inputs = std::to_string(layer->getWeight().getColumnSize());
+        const std::string output = "layer" + n;
+        body << "    alignas(64) float " << output << "[" << neurons << "] = {};\n"
+             << "    for (std::size_t k = 0; k < " << inputs << "; k ++) {\n"
+             << "        for (std::size_t i = 0; i < " << neurons << "; i ++) " << output << "[i] += layer" << n << "Weights[k][i] * " << input << "[k];\n"
+             << "    }\n"
+             << "    for (std::size_t i = 0; i < " << neurons << "; i ++) {\n"
+             << "        const float x = " << output << "[i] + layer" << n << "Biases[i];\n"
+             << "        " << output << "[i] = " << activationToCpp(*layer->getActivation()) << ";\n"
+             << "    }\n";
+        input = output;
+        outputCount = layer->getNeuronCount();
+        layer = layer->getNextLayer();
+    }
+    body << "    for (std::size_t i = 0; i < " << outputCount << "; i ++) output[i] = " << input << "[i];\n";
+
+    file << "// Generated by HeaderExportVisitor from a trained model, do not edit.\n\n"
+         << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+         << "#include <algorithm>\n#include <cmath>\n#include <cstddef>\n\n"
+         << "namespace " << this->_name << " {\n\n"
+         << "inline constexpr std::size_t inputCount = " << inputCount << ";\n"
+         << "inline constexpr std::size_t outputCount = " << outputCount << ";\n\n"
+         << this->_arrays.str()
+         << "/* input holds inputCount floats, output receives outputCount floats */\n"
+         << "inline void predict(const float* input, float* output) {\n"
+         << body.str()
+         << "}\n\n"
+         << "} // namespace " << this->_name << "\n\n"
+         << "#endif // " << guard << "\n";
+    file.close();
+}
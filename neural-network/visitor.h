@@ -10,6 +10,7 @@
 #include <string>
 #include <utility>
 #include <fstream>
+#include <sstream>
 
 #include "model.h"
 
@@ -53,4 +54,24 @@ private:
     std::string _path;
 };
 
+/*
+ * Writes the model as a self-contained C++ header: constexpr weight arrays and a `predict(const float*, float*)`
+ * function specialised for the model's exact topology and activations, so it can be embedded without any
+ * file I/O or allocation. The weights and biases are buffered and the header is written once the activations
+ * are visited, so the three visits must happen in that order (see Model::saveHeader).
+ * */
+class HeaderExportVisitor : public Visitor {
+public:
+    HeaderExportVisitor(std::string path, std::string name) : _path(std::move(path)), _name(std::move(name)) {}
+    ~HeaderExportVisitor() = default;
+    void doSomethingWithWeight(Model * model) override;
+    void doSomethingWithBias(Model * model) override;
+    void doSomethingWithActivations(Model * model) override;
+
+private:
+    std::string _path;
+    std::string _name;
+    std::ostringstream _arrays;
+};
+
 #endif
@@ -2,32 +2,214 @@
 // Created by Emir Tuncbilek on 8/19/24.
 //
 
+/*
+ * Evaluates the exported model, and its int8 quantization, on the preprocessed dataset.
+ *
+ *   F1_STRATEGIES_RUN [--threads <n>] [--batch <n>] [--samples] [--ensemble <model> <model> ...]
+ *
+ * The dataset is split in contiguous shards, one per thread, and every shard runs the float model batch by
+ * batch. The shards keep their own statistics, which are merged in order once they're done, so the summary
+ * doesn't depend on the thread count. Percentiles come from streaming histograms, so the memory stays the same
+ * whatever the size of the dataset, both for the mean deviation of the samples and for the absolute error of
+ * every sector output. --samples prints the deviation of every sample, each shard buffers its
+ * lines and they're written in dataset order after the merge. --ensemble also scores the mean of the models saved
+ * under those names (see F1_STRATEGIES --save-as) and reports their spread, the band the strategy side draws from.
+ * */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <thread>
+
 #include "./neural-network/model.h"
+#include "./neural-network/quantized-model.h"
+#include "./neural-network/ensemble.h"
+#include "./neural-network/error-histogram.h"
 #include "./data-interpretor/data-loader.h"
 
+/* PREDICT DEFAULTS */
+#define DEFAULT_PREDICT_BATCH_SIZE 256
+
+struct EvaluationStats {
+    size_t count = 0;
+    double totalDeviation = 0.0;
+    long minIndex = -1, maxIndex = -1;
+    double maxDeviation = 0.0, minDeviation = 1.0;
+    double totalQuantizedDeviation = 0.0, maxQuantizedDrift = 0.0;
+    ErrorHistogram deviations;
+    ErrorHistogram quantizedDeviations;
+    ErrorMetrics outputErrors;
+    ErrorMetrics quantizedOutputErrors;
+    std::string samples;    // per sample lines, only filled when they are asked for
+
+    void add(const long& index, const double& diff, const double& quantizedDiff, const double& drift);
+    /* other must cover the samples right after this one's, ties keep the first position like a single pass would */
+    void merge(const EvaluationStats& other);
+};
+
+/* Utility functions */
+void EvaluationStats::add(const long &index, const double &diff, const double &quantizedDiff, const double &drift) {
+    this->count ++;
+    this->totalDeviation += diff;
+    this->totalQuantizedDeviation += quantizedDiff;
+    this->maxQuantizedDrift = std::max(this->maxQuantizedDrift, drift);
+    if (diff > this->maxDeviation) { this->maxDeviation = diff; this->maxIndex = index; }
+    if (diff < this->minDeviation) { this->minDeviation = diff; this->minIndex = index; }
+    this->deviations.add(diff);
+    this->quantizedDeviations.add(quantizedDiff);
+}
+
+void EvaluationStats::merge(const EvaluationStats &other) {
+    this->count += other.count;
+    this->totalDeviation += other.totalDeviation;
+    this->totalQuantizedDeviation += other.totalQuantizedDeviation;
+    this->maxQuantizedDrift = std::max(this->maxQuantizedDrift, other.maxQuantizedDrift);
+    if (other.maxDeviation > this->maxDeviation) { this->maxDeviation = other.maxDeviation; this->maxIndex = other.maxIndex; }
+    if (other.minDeviation < this->minDeviation) { this->minDeviation = other.minDeviation; this->minIndex = other.minIndex; }
+    this->deviations.merge(other.deviations);
+    this->quantizedDeviations.merge(other.quantizedDeviations);
+    this->outputErrors.merge(other.outputErrors);
+    this->quantizedOutputErrors.merge(other.quantizedOutputErrors);
+    this->samples += other.samples;
+}
+
+EvaluationStats evaluateShard(Model& model, const QuantizedModel& quantizedModel, const std::vector<Matrix>& X,
+                              const std::vector<Matrix>& targets, const size_t& first, const size_t& last,
+                              const size_t& batchSize, const bool& printSamples) {
+    EvaluationStats stats;
+    std::ostringstream lines;
+    const size_t inputs = X.empty() ? 0 : X[0].getRowSize();
+    for (size_t start = first; start < last; start += batchSize) {
+        const size_t size = std::min(batchSize, last - start);
+        Matrix::Rows columns = Matrix::allocateRows(inputs, size);
+        for (size_t j = 0; j < size; j ++) {
+            for (size_t i = 0; i < inputs; i ++) {
+                columns[i][j] = X[start + j](i, 0);
+            }
+        }
+        const Matrix batch(std::move(columns));
+        const Matrix results = model.predictBatch(batch);
+        const Matrix quantizedResults = quantizedModel.predictBatch(batch);
+        const size_t outputs = results.getRowSize();
+        for (size_t j = 0; j < size; j ++) {
+            const size_t index = start + j;
+            double diff = 0.0, quantizedDiff = 0.0, drift = 0.0;
+            for (size_t o = 0; o < outputs; o ++) {
+                diff += std::abs(targets[index](o, 0) - results(o, j));
+                quantizedDiff += std::abs(targets[index](o, 0) - quantizedResults(o, j));
+                drift += std::abs(results(o, j) - quantizedResults(o, j));
+            }
+            diff /= (double)outputs;
+            quantizedDiff /= (double)outputs;
+            drift /= (double)outputs;
+            stats.add((long)index, diff, quantizedDiff, drift);
+            stats.outputErrors.add(targets[index], results, j);
+            stats.quantizedOutputErrors.add(targets[index], quantizedResults, j);
+            if (printSamples)
+                lines << "@ [" << index + 1 << "] -> Deviation (%) : " << diff * 100. << " | int8 : " << quantizedDiff * 100. << "\n";
+        }
+    }
+    stats.samples = lines.str();
+    return stats;
+}
+
+/* the members' mean scored like the model, and how wide their spread is around the targets */
+void evaluateEnsemble(const Ensemble& ensemble, const std::vector<Matrix>& X, const std::vector<Matrix>& targets, const size_t& batchSize) {
+    const size_t inputs = X.empty() ? 0 : X[0].getRowSize(), outputs = ensemble.getOutputCount();
+    double totalDeviation = 0., totalStdDev = 0.;
+    size_t covered = 0;
+    for (size_t start = 0; start < X.size(); start += batchSize) {
+        const size_t size = std::min(batchSize, X.size() - start);
+        Matrix::Rows columns = Matrix::allocateRows(inputs, size);
+        for (size_t j = 0; j < size; j ++) {
+            for (size_t i = 0; i < inputs; i ++) {
+                columns[i][j] = X[start + j](i, 0);
+            }
+        }
+        const EnsemblePrediction prediction = ensemble.predict(Matrix(std::move(columns)));
+        for (size_t j = 0; j < size; j ++) {
+            for (size_t o = 0; o < outputs; o ++) {
+                const double error = std::abs(targets[start + j](o, 0) - prediction.mean(o, j));
+                const double stdDev = std::sqrt(prediction.variance(o, j));
+                totalDeviation += error / (double)outputs;
+                totalStdDev += stdDev / (double)outputs;
+                if (error <= 2. * stdDev) covered ++;
+            }
+        }
+    }
+    std::cout << "Ensemble of " << ensemble.getMemberCount() << " avg accuracy : " << (1. - totalDeviation / (double)X.size()) * 100. << " %" << std::endl;
+    std::cout << "Ensemble mean std dev (%) : " << totalStdDev / (double)X.size() * 100. << " | targets within 2 std dev : "
+              << (double)covered / (double)(X.size() * outputs) * 100. << " %" << std::endl;
+}
+
 int main(int argc, char* argv[]) {
+    size_t threadCount = std::thread::hardware_concurrency(), batchSize = DEFAULT_PREDICT_BATCH_SIZE;
+    bool printSamples = false;
+    std::vector<std::string> ensembleModels;
+    for (int i = 1; i < argc; i ++) {
+        const std::string argument = argv[i];
+        if (argument == "--threads" && i + 1 < argc) threadCount = std::stoul(argv[++ i]);
+        else if (argument == "--batch" && i + 1 < argc) batchSize = std::max<size_t>(std::stoul(argv[++ i]), 1);
+        else if (argument == "--samples") printSamples = true;
+        else if (argument == "--ensemble" && i + 1 < argc) {
+            while (i + 1 < argc && !std::string(argv[i + 1]).starts_with("--")) ensembleModels.emplace_back(argv[++ i]);
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--threads <n>] [--batch <n>] [--samples] [--ensemble <model> <model> ...]" << std::endl;
+            return 1;
+        }
+    }
+#if USE_GPU
+    // the layers share one OpenCL queue
+    threadCount = 1;
+#endif
 
     auto model = Model::importModel("file.model");
+    auto quantizedModel = QuantizedModel::importModel("file.model");
     std::cout << "Model loaded" << std::endl;
     const std::pair<std::vector<float>, size_t> Xdata = DataLoader::load("../x-preprocessed-data.csv");
     const std::pair<std::vector<float>, size_t> targetData = DataLoader::load("../y-preprocessed-data.csv");
     auto X = DataLoader::generateVectors(Xdata);
     auto targets = DataLoader::generateVectors(targetData);
-    double totalDeviation = 0.0;
-    int minIndex = -1, maxIndex = -1;
-    double maxDeviation = 0.0, minDeviation = 1.0;
-    for (int i = 0; i < X.size(); i ++) {
-        auto result = model->predict(X[i]);
-        auto diff = (targets[i] - result).map([](auto x) { return abs(x); }).sum() / (double)result.getRowSize();
-        totalDeviation += diff;
-        if (diff > maxDeviation) { maxDeviation = diff; maxIndex = i; }
-        if (diff < minDeviation) { minDeviation = diff; minIndex = i; }
-        std::cout << "@ [" << i + 1 << "] -> Deviation (%) : " << diff * 100. << std::endl;
+    if (X.size() != targets.size())
+        throw std::invalid_argument("The inputs and the targets don't hold the same number of samples!");
+
+    const auto start = std::chrono::steady_clock::now();
+    threadCount = std::clamp<size_t>(threadCount, 1, std::max<size_t>(X.size(), 1));
+    std::vector<EvaluationStats> shards(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t ++) {
+        threads.emplace_back([&, t]() {
+            shards[t] = evaluateShard(*model, *quantizedModel, X, targets, X.size() * t / threadCount,
+                                      X.size() * (t + 1) / threadCount, batchSize, printSamples);
+        });
     }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EvaluationStats stats;
+    for (const EvaluationStats& shard : shards) {
+        stats.merge(shard);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (printSamples) std::cout << stats.samples << std::flush;
+    std::cout << "Evaluated " << stats.count << " samples in " << seconds << " s on " << threadCount << " thread(s)" << std::endl;
+    std::cout << "Avg accuracy : " << ( 1. - stats.totalDeviation / (double) X.size()) * 100. << " %" << std::endl;
+    std::cout << "Min deviation : " << stats.minDeviation * 100. << " % @ position: " << stats.minIndex + 1 << std::endl;
+    std::cout << "Max deviation : " << stats.maxDeviation * 100. << " % @ position: " << stats.maxIndex + 1 << std::endl;
+    std::cout << "Deviation (%) p50 : " << stats.deviations.quantile(0.5) * 100. << " | p90 : "
+              << stats.deviations.quantile(0.9) * 100. << " | p99 : " << stats.deviations.quantile(0.99) * 100. << std::endl;
+    stats.outputErrors.print(std::cout, "Absolute error (%), sector", 100.);
+    std::cout << "Int8 avg accuracy : " << ( 1. - stats.totalQuantizedDeviation / (double) X.size()) * 100. << " %" << std::endl;
+    std::cout << "Int8 deviation (%) p50 : " << stats.quantizedDeviations.quantile(0.5) * 100. << " | p90 : "
+              << stats.quantizedDeviations.quantile(0.9) * 100. << " | p99 : " << stats.quantizedDeviations.quantile(0.99) * 100. << std::endl;
+    stats.quantizedOutputErrors.print(std::cout, "Int8 absolute error (%), sector", 100.);
+    std::cout << "Int8 vs float max deviation : " << stats.maxQuantizedDrift * 100. << " %" << std::endl;
 
-    std::cout << "Avg accuracy : " << ( 1. - totalDeviation / (double) X.size()) * 100. << " %" << std::endl;
-    std::cout << "Min deviation : " << minDeviation * 100. << " % @ position: " << minIndex + 1 << std::endl;
-    std::cout << "Max deviation : " << maxDeviation * 100. << " % @ position: " << maxIndex + 1 << std::endl;
+    if (!ensembleModels.empty()) evaluateEnsemble(*Ensemble::importModels(ensembleModels), X, targets, batchSize);
 
     return 0;
 }
@@ -0,0 +1,164 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+/*
+ * Plays a historical session back as a live feed, to test the live path without a live race and as a load
+ * generator for the ingestion and inference stack.
+ *
+ *   F1_STRATEGIES_REPLAY <session.csv> [--socket <path> | --loopback] [--speed <x>] [--max-gap-ms <ms>]
+ *                        [--scalers <XScaler.json> <YScaler.json>] [--race-laps <n>]
+ *
+ * --socket writes to a LiveFeed listening on that Unix socket, --loopback (the default) runs the LiveFeed, the
+ * model and a strategy replan of the lap's car in this process and reports their end-to-end latency. --speed 1
+ * is real time, 10 is 10x and 0 writes the records back to back. The loopback scales with the scalers
+ * collect_data.py saved when they are given, and with min-max scalers fitted on the replayed session otherwise;
+ * --race-laps is the length of the race the cars are replanned for.
+ * */
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "./neural-network/model.h"
+#include "./data-interpretor/live-feed.h"
+#include "./data-interpretor/session-replay.h"
+#include "./strategy/strategy.h"
+
+/* REPLAY DEFAULTS */
+#define DEFAULT_REPLAY_SPEED 10.
+#define DEFAULT_MAX_GAP_MS 5000.
+#define DEFAULT_RACE_LAPS 57
+#define DEFAULT_PIT_LOSS_MS 22000.
+
+/* Utility functions */
+
+/*
+ * The strategy side of the loopback: every car gets a StrategyEngine on its first lap, over a DegradationTable of
+ * the model for that lap, and is replanned from each of its laps with the decay observed on it. It runs in the
+ * LiveFeed's callback, on the inference thread, so the model is only used from there and the feed's latency
+ * covers the replan.
+ * */
+class StrategyDesk {
+public:
+    StrategyDesk(Model& model, const Scaler& inputScaler, const Scaler& outputScaler, const int& raceLaps) :
+            model(model), inputScaler(inputScaler), outputScaler(outputScaler), raceLaps(raceLaps) {}
+
+    void onLap(const TimingRecord& lap) {
+        Car& car = this->cars[lap.driver];
+        if (!car.engine) {
+            CarProfile profile;
+            const std::array<double, FEATURE_COUNT> features = lap.features();
+            profile.features.resize(FEATURE_COUNT);
+            this->inputScaler.transform(features.data(), profile.features.data());
+            profile.compoundRange = this->inputScaler.getRange(FEATURE_COMPOUND);
+            profile.tyreLifeRange = this->inputScaler.getRange(FEATURE_TYRE_LIFE);
+            for (size_t s = 0; s < SECTOR_COUNT; s ++) profile.decayRanges[s] = this->outputScaler.getRange(s);
+            RaceParameters race;
+            race.raceLaps = this->raceLaps;
+            race.pitLossMs = DEFAULT_PIT_LOSS_MS;
+            race.baseLapTimeMs = lap.lapTimeMs;
+            race.availableSets = {2, 2, 2, 0, 0};
+            car.engine = std::make_unique<StrategyEngine>(race, std::make_shared<DegradationTable>(this->model, profile, this->raceLaps));
+        }
+        // every session starts the car's stints over
+        if (lap.session != car.session) car.stintCompounds.clear();
+        if (car.stintCompounds.empty() || lap.stint != car.stint) car.stintCompounds.push_back(lap.compound);
+        car.session = lap.session;
+        car.stint = lap.stint;
+
+        const RaceParameters& race = car.engine->getRace();
+        if (lap.lapNumber >= race.raceLaps || lap.tyreLife < 1 || race.availableSets[static_cast<int>(lap.compound)] <= 0) return;
+        const std::vector<StrategyPlan> plans = car.engine->replan({lap.lapNumber, lap.tyreLife, car.stintCompounds, lap.decayRatesMs});
+        this->replans ++;
+        if (!plans.empty()) this->planned ++;
+    }
+
+    [[nodiscard]] size_t getCarCount() const { return this->cars.size(); }
+    [[nodiscard]] size_t getReplans() const { return this->replans; }
+    [[nodiscard]] size_t getPlanned() const { return this->planned; }
+
+private:
+    struct Car {
+        std::unique_ptr<StrategyEngine> engine;
+        std::vector<Compound> stintCompounds;
+        int session = -1;
+        int stint = 0;
+    };
+
+    Model& model;
+    const Scaler& inputScaler;
+    const Scaler& outputScaler;
+    int raceLaps;
+    std::map<int, Car> cars;
+    size_t replans = 0;
+    size_t planned = 0;     // replans that found a way to the flag
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <session.csv> [--socket <path> | --loopback] [--speed <x>] [--max-gap-ms <ms>]"
+                  << " [--scalers <XScaler.json> <YScaler.json>] [--race-laps <n>]" << std::endl;
+        return 1;
+    }
+    std::string socketPath, inputScalerPath, outputScalerPath;
+    double speed = DEFAULT_REPLAY_SPEED, maxGapMs = DEFAULT_MAX_GAP_MS;
+    int raceLaps = DEFAULT_RACE_LAPS;
+    for (int i = 2; i < argc; i ++) {
+        const std::string argument = argv[i];
+        if (argument == "--socket" && i + 1 < argc) socketPath = argv[++ i];
+        else if (argument == "--loopback") socketPath.clear();
+        else if (argument == "--speed" && i + 1 < argc) speed = std::stod(argv[++ i]);
+        else if (argument == "--max-gap-ms" && i + 1 < argc) maxGapMs = std::stod(argv[++ i]);
+        else if (argument == "--race-laps" && i + 1 < argc) raceLaps = std::stoi(argv[++ i]);
+        else if (argument == "--scalers" && i + 2 < argc) {
+            inputScalerPath = argv[++ i];
+            outputScalerPath = argv[++ i];
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    const SessionReplay replay = SessionReplay::load(argv[1]);
+    std::cout << "Replaying " << replay.size() << " laps at " << (speed == REPLAY_UNTHROTTLED ? std::string("full speed") : std::to_string(speed) + "x") << std::endl;
+
+    if (!socketPath.empty()) {
+        const int connection = SessionReplay::connect(socketPath);
+        const ReplayStats stats = replay.play(connection, speed, maxGapMs);
+        ::close(connection);
+        std::cout << "Sent " << stats.records << " records in " << stats.seconds << " s : " << stats.recordsPerSecond << " records/s" << std::endl;
+        if (stats.readerLeft) std::cout << "The feed closed the socket after " << stats.records << " of " << replay.size() << " records" << std::endl;
+        std::cout << "Lateness : " << stats.lateness << std::endl;
+        return 0;
+    }
+
+    auto model = Model::importModel("file.model");
+    int sockets[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) < 0) {
+        std::cerr << "Unable to create a socket pair!" << std::endl;
+        return 1;
+    }
+    const Scaler inputScaler = inputScalerPath.empty() ? replay.getInputScaler() : Scaler::load(inputScalerPath);
+    const Scaler outputScaler = outputScalerPath.empty() ? replay.getOutputScaler() : Scaler::load(outputScalerPath);
+    StrategyDesk desk(*model, inputScaler, outputScaler, raceLaps);
+    LiveFeed feed(*model, inputScaler, outputScaler, [&desk](const TimingRecord& lap, const SectorDecay&) { desk.onLap(lap); });
+    feed.start(sockets[0]);
+    const ReplayStats stats = replay.play(sockets[1], speed, maxGapMs);
+    ::close(sockets[1]);
+    feed.wait();
+    const LiveFeedStats feedStats = feed.getStats();
+
+    std::cout << "Sent " << stats.records << " records in " << stats.seconds << " s : " << stats.recordsPerSecond << " records/s" << std::endl;
+    std::cout << "Lateness : " << stats.lateness << std::endl;
+    std::cout << "Inferred " << feedStats.laps << " laps (" << feedStats.skippedLines << " lines skipped, "
+              << feedStats.bufferFullWaits << " waits on a full buffer)" << std::endl;
+    std::cout << "Replanned " << desk.getReplans() << " laps of " << desk.getCarCount() << " cars, " << desk.getPlanned()
+              << " with a way to the flag" << std::endl;
+    std::cout << "End-to-end latency (inference and replan) : " << feedStats.latency << std::endl;
+    return 0;
+}
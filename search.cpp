@@ -0,0 +1,84 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+/*
+ * Hyperparameter search over the tyre decay model, see HyperparameterSearch.
+ *
+ *   F1_STRATEGIES_SEARCH [--configurations <n>] [--min-epochs <n>] [--max-epochs <n>] [--reduction <n>]
+ *                        [--threads <n>] [--seed <n>] [--leaderboard <path>] [--model <name>]
+ *
+ * The last tenth of the preprocessed dataset is held out to rank the configurations, like main does for early
+ * stopping. The leaderboard is printed and written as CSV (search_leaderboard.csv by default) and the best model
+ * is saved like main saves its own (best.model by default, see Model::save).
+ * */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "./neural-network/hyperparameter-search.h"
+#include "./data-interpretor/data-loader.h"
+
+/* SEARCH DEFAULTS */
+#define DEFAULT_LEADERBOARD_PATH "search_leaderboard.csv"
+#define DEFAULT_SEARCH_MODEL "best.model"
+#define LEADERBOARD_PRINTED_ROWS 10
+
+int main(int argc, char* argv[]) {
+    SearchParameters parameters;
+    std::string leaderboardPath = DEFAULT_LEADERBOARD_PATH, modelName = DEFAULT_SEARCH_MODEL;
+    for (int i = 1; i < argc; i ++) {
+        const std::string argument = argv[i];
+        if (argument == "--configurations" && i + 1 < argc) parameters.configurationCount = std::stoul(argv[++ i]);
+        else if (argument == "--min-epochs" && i + 1 < argc) parameters.minEpochs = std::stoi(argv[++ i]);
+        else if (argument == "--max-epochs" && i + 1 < argc) parameters.maxEpochs = std::stoi(argv[++ i]);
+        else if (argument == "--reduction" && i + 1 < argc) parameters.reduction = std::stoul(argv[++ i]);
+        else if (argument == "--threads" && i + 1 < argc) parameters.threadCount = std::stoul(argv[++ i]);
+        else if (argument == "--seed" && i + 1 < argc) parameters.seed = std::stoul(argv[++ i]);
+        else if (argument == "--leaderboard" && i + 1 < argc) leaderboardPath = argv[++ i];
+        else if (argument == "--model" && i + 1 < argc) modelName = argv[++ i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--configurations <n>] [--min-epochs <n>] [--max-epochs <n>] [--reduction <n>]"
+                      << " [--threads <n>] [--seed <n>] [--leaderboard <path>] [--model <name>]" << std::endl;
+            return 1;
+        }
+    }
+
+    auto X = DataLoader::generateVectors(DataLoader::load("../x-preprocessed-data.csv"));
+    auto Y = DataLoader::generateVectors(DataLoader::load("../y-preprocessed-data.csv"));
+    const size_t trainingSize = X.size() - X.size() / 10;
+    const std::vector<Matrix> validationX(X.begin() + (long)trainingSize, X.end());
+    const std::vector<Matrix> validationY(Y.begin() + (long)trainingSize, Y.end());
+    X.erase(X.begin() + (long)trainingSize, X.end());
+    Y.erase(Y.begin() + (long)trainingSize, Y.end());
+
+    SearchSpace space;
+    space.hiddenLayers = {{32}, {64}, {32, 32}, {64, 64}, {64, 64, 9}, {128, 64}};
+    space.activations = {std::make_shared<TanH>(0.01), std::make_shared<TanH>(0.01, true), std::make_shared<Sigmoid>(),
+                         std::make_shared<LeakyReLU>(0.01), std::make_shared<ELU>(1.)};
+    space.optimizers = {OptimizerKind::SGD, OptimizerKind::RMSPROP, OptimizerKind::ADAM, OptimizerKind::ADAGRAD, OptimizerKind::ADA_DELTA};
+    space.batchSizes = {1, 3, 8, 16, 32};
+    space.minLearningRate = 1e-4;
+    space.maxLearningRate = 5e-2;
+    space.minLambda = 1e-3;
+    space.maxLambda = 0.5;
+
+    HyperparameterSearch search(space, parameters);
+    const std::vector<SearchResult> leaderboard = search.run(X, Y, validationX, validationY);
+
+    for (size_t i = 0; i < leaderboard.size() && i < LEADERBOARD_PRINTED_ROWS; i ++) {
+        std::cout << "#" << i + 1 << " : validation loss " << leaderboard[i].validationLoss << " after "
+                  << leaderboard[i].epochs << " epochs | " << leaderboard[i].configuration.describe()
+                  << (leaderboard[i].failure.empty() ? "" : " | failed : " + leaderboard[i].failure) << std::endl;
+    }
+    std::ofstream file(leaderboardPath);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file!" << std::endl;
+        return 1;
+    }
+    HyperparameterSearch::writeLeaderboard(file, leaderboard);
+    search.takeBestModel()->save(modelName);
+    std::cout << "Best model saved!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,67 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+/*
+ * Micro-batching inference daemon, see data-interpretor/inference-server.h. Stops on SIGINT or SIGTERM and
+ * prints its statistics.
+ *
+ *   F1_STRATEGIES_SERVE <socket> [--scalers <XScaler.json> <YScaler.json>] [--max-batch <n>] [--max-wait-us <us>]
+ *
+ * Without scalers the requests hold scaled features and get scaled predictions back.
+ * */
+
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "./neural-network/model.h"
+#include "./data-interpretor/inference-server.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <socket> [--scalers <XScaler.json> <YScaler.json>] [--max-batch <n>] [--max-wait-us <us>]" << std::endl;
+        return 1;
+    }
+    std::string inputScalerPath, outputScalerPath;
+    size_t maxBatch = INFERENCE_MAX_BATCH;
+    long maxWaitUs = INFERENCE_MAX_WAIT_US;
+    for (int i = 2; i < argc; i ++) {
+        const std::string argument = argv[i];
+        if (argument == "--scalers" && i + 2 < argc) {
+            inputScalerPath = argv[++ i];
+            outputScalerPath = argv[++ i];
+        }
+        else if (argument == "--max-batch" && i + 1 < argc) maxBatch = std::stoul(argv[++ i]);
+        else if (argument == "--max-wait-us" && i + 1 < argc) maxWaitUs = std::stol(argv[++ i]);
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    auto model = Model::importModel("file.model");
+    const size_t inputs = model->getInputLayer()->getNeuronCount();
+    const size_t outputs = model->predictBatch(Matrix::nullMatrix(inputs, 1)).getRowSize();
+    // identity scalers when none are given
+    Scaler inputScaler = inputScalerPath.empty() ? Scaler(std::vector<double>(inputs, 0.), std::vector<double>(inputs, 1.)) : Scaler::load(inputScalerPath);
+    Scaler outputScaler = outputScalerPath.empty() ? Scaler(std::vector<double>(outputs, 0.), std::vector<double>(outputs, 1.)) : Scaler::load(outputScalerPath);
+    InferenceServer server(*model, inputScaler, outputScaler, maxBatch, std::chrono::microseconds(maxWaitUs));
+
+    // the signals are handled synchronously by this thread, the server threads inherit the mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    std::thread serving([&server, &argv]() { server.serve(argv[1]); });
+    std::cout << "Serving on " << argv[1] << " (batches of up to " << maxBatch << ", " << maxWaitUs << " us max wait)" << std::endl;
+    int signal;
+    sigwait(&signals, &signal);
+    server.stop();
+    serving.join();
+    std::cout << server.getStats() << std::endl;
+    return 0;
+}
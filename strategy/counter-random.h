@@ -0,0 +1,45 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_COUNTER_RANDOM_H
+#define F1_STRATEGIES_COUNTER_RANDOM_H
+
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+/*
+ * Counter-based random numbers: a draw is a pure function of (seed, stream, channel, counter), hashed with the
+ * SplitMix64 finalizer, so there is no state to share or advance between threads. Giving every simulated
+ * scenario its own stream makes the results independent of which thread runs it, or of the thread count.
+ * */
+class CounterRandom {
+public:
+    CounterRandom(const uint64_t& seed, const uint64_t& stream) : key(CounterRandom::mix(seed ^ CounterRandom::mix(stream))) {}
+
+    /* uniform in [0, 1) */
+    [[nodiscard]] double uniform(const uint64_t& channel, const uint64_t& counter) const {
+        const uint64_t bits = CounterRandom::mix(this->key ^ CounterRandom::mix(channel + CounterRandom::mix(counter)));
+        return static_cast<double>(bits >> 11) * 0x1.0p-53;   // the 53 high bits fill a double's mantissa
+    }
+
+    /* standard normal, Box-Muller on two uniforms of the channel */
+    [[nodiscard]] double normal(const uint64_t& channel, const uint64_t& counter) const {
+        const double u1 = 1. - this->uniform(channel, 2 * counter);     // in (0, 1], log stays finite
+        const double u2 = this->uniform(channel, 2 * counter + 1);
+        return std::sqrt(-2. * std::log(u1)) * std::cos(2. * std::numbers::pi * u2);
+    }
+
+private:
+    static uint64_t mix(uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t key;
+};
+
+#endif //F1_STRATEGIES_COUNTER_RANDOM_H
@@ -0,0 +1,143 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "degradation.h"
+
+#include <cmath>
+#include <sstream>
+
+/* Utility functions */
+namespace {
+
+    void checkTyreLife(const int& tyreLife, const int& maxTyreLife) {
+        if (tyreLife < 1 || tyreLife > maxTyreLife) {
+            std::ostringstream oss;
+            oss << "Tyre life " << tyreLife << " is outside of the table's range [1, " << maxTyreLife << "].";
+            throw std::invalid_argument(oss.str());
+        }
+    }
+
+}
+
+std::vector<double> CarProfile::input(const Compound &compound, const int &tyreLife) const {
+    std::vector<double> input = this->features;
+    input[FEATURE_COMPOUND] = this->compoundRange.scale(static_cast<double>(compound));
+    input[FEATURE_TYRE_LIFE] = this->tyreLifeRange.scale(tyreLife);
+    return input;
+}
+
+ModelDegradation::ModelDegradation(Model &model, CarProfile car) : model(model), car(std::move(car)) {
+    if (this->car.features.size() != FEATURE_COUNT)
+        throw std::invalid_argument("A car profile must hold one value per model input!");
+}
+
+SectorDecay ModelDegradation::decay(const Compound &compound, const int &tyreLife) {
+    const Matrix prediction = this->model.predict(Matrix::columnVector(this->car.input(compound, tyreLife)));
+    SectorDecay result;
+    for (size_t s = 0; s < SECTOR_COUNT; s ++) {
+        result[s] = this->car.decayRanges[s].unscale(prediction(s, 0));
+    }
+    return result;
+}
+
+DegradationTable::DegradationTable(Model &model, CarProfile car, const int &maxTyreLife) :
+        model(model), car(std::move(car)), maxTyreLife(maxTyreLife), builtRevision(0), valid(false) {
+    if (this->car.features.size() != FEATURE_COUNT)
+        throw std::invalid_argument("A car profile must hold one value per model input!");
+    if (maxTyreLife <= 0)
+        throw std::invalid_argument("The tyre-life range must hold at least one lap!");
+}
+
+SectorDecay DegradationTable::decay(const Compound &compound, const int &tyreLife) {
+    checkTyreLife(tyreLife, this->maxTyreLife);
+    if (!this->isValid()) this->build();
+    return this->table[static_cast<int>(compound) * this->maxTyreLife + tyreLife - 1];
+}
+
+void DegradationTable::setCar(CarProfile car) {
+    if (car.features.size() != FEATURE_COUNT)
+        throw std::invalid_argument("A car profile must hold one value per model input!");
+    this->car = std::move(car);
+    this->invalidate();
+}
+
+void DegradationTable::build() {
+    std::vector<std::vector<double>> samples;
+    samples.reserve(COMPOUND_COUNT * this->maxTyreLife);
+    for (int c = 0; c < COMPOUND_COUNT; c ++) {
+        for (int tyreLife = 1; tyreLife <= this->maxTyreLife; tyreLife ++) {
+            samples.push_back(this->car.input(static_cast<Compound>(c), tyreLife));
+        }
+    }
+    const Matrix predictions = this->model.predictBatch(Matrix::fromColumns(samples));
+    this->table.resize(samples.size());
+    for (size_t j = 0; j < samples.size(); j ++) {
+        for (size_t s = 0; s < SECTOR_COUNT; s ++) {
+            this->table[j][s] = this->car.decayRanges[s].unscale(predictions(s, j));
+        }
+    }
+    this->builtRevision = this->model.getRevision();
+    this->valid = true;
+}
+
+EnsembleDegradation::EnsembleDegradation(const Ensemble &ensemble, CarProfile car, const int &maxTyreLife) :
+        ensemble(ensemble), car(std::move(car)), maxTyreLife(maxTyreLife), valid(false) {
+    if (this->car.features.size() != FEATURE_COUNT)
+        throw std::invalid_argument("A car profile must hold one value per model input!");
+    if (maxTyreLife <= 0)
+        throw std::invalid_argument("The tyre-life range must hold at least one lap!");
+}
+
+SectorDecay EnsembleDegradation::decay(const Compound &compound, const int &tyreLife) {
+    return this->means[this->index(compound, tyreLife)];
+}
+
+SectorDecay EnsembleDegradation::decayStdDev(const Compound &compound, const int &tyreLife) {
+    return this->stdDevs[this->index(compound, tyreLife)];
+}
+
+void EnsembleDegradation::setCar(CarProfile car) {
+    if (car.features.size() != FEATURE_COUNT)
+        throw std::invalid_argument("A car profile must hold one value per model input!");
+    this->car = std::move(car);
+    this->valid = false;
+}
+
+size_t EnsembleDegradation::index(const Compound &compound, const int &tyreLife) {
+    checkTyreLife(tyreLife, this->maxTyreLife);
+    if (!this->valid) this->build();
+    return static_cast<int>(compound) * this->maxTyreLife + tyreLife - 1;
+}
+
+void EnsembleDegradation::build() {
+    std::vector<std::vector<double>> samples;
+    samples.reserve(COMPOUND_COUNT * this->maxTyreLife);
+    for (int c = 0; c < COMPOUND_COUNT; c ++) {
+        for (int tyreLife = 1; tyreLife <= this->maxTyreLife; tyreLife ++) {
+            samples.push_back(this->car.input(static_cast<Compound>(c), tyreLife));
+        }
+    }
+    const EnsemblePrediction predictions = this->ensemble.predict(Matrix::fromColumns(samples));
+    this->means.resize(samples.size());
+    this->stdDevs.resize(samples.size());
+    for (size_t j = 0; j < samples.size(); j ++) {
+        for (size_t s = 0; s < SECTOR_COUNT; s ++) {
+            const FeatureRange& range = this->car.decayRanges[s];
+            this->means[j][s] = range.unscale(predictions.mean(s, j));
+            // unscaling is affine, the spread only takes the range's width
+            this->stdDevs[j][s] = std::sqrt(predictions.variance(s, j)) * std::abs(range.max - range.min);
+        }
+    }
+    this->valid = true;
+}
+
+SectorDecay PrecomputedDegradation::decay(const Compound &compound, const int &tyreLife) {
+    const std::vector<SectorDecay>& curve = this->curves[static_cast<int>(compound)];
+    if (tyreLife < 1 || tyreLife > (int)curve.size()) {
+        std::ostringstream oss;
+        oss << "No " << compoundToStr(compound) << " decay for a tyre life of " << tyreLife << ".";
+        throw std::invalid_argument(oss.str());
+    }
+    return curve[tyreLife - 1];
+}
@@ -0,0 +1,114 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_DEGRADATION_H
+#define F1_STRATEGIES_DEGRADATION_H
+
+#include <array>
+#include <vector>
+
+#include "../neural-network/model.h"
+#include "../neural-network/ensemble.h"
+#include "../data-interpretor/scaler.h"
+#include "./features.h"
+
+/* What the model needs to know about a car besides the tyre it runs */
+struct CarProfile {
+    std::vector<double> features;                           // one scaled input row, e.g. the car's latest lap
+    FeatureRange compoundRange;                             // scaling of FEATURE_COMPOUND
+    FeatureRange tyreLifeRange;                             // scaling of FEATURE_TYRE_LIFE
+    std::array<FeatureRange, SECTOR_COUNT> decayRanges;     // scaling of the model's outputs
+
+    /* the model input for this car on the given tyre */
+    [[nodiscard]] std::vector<double> input(const Compound& compound, const int& tyreLife) const;
+};
+
+class DegradationSource {
+public:
+    DegradationSource() = default;
+    virtual ~DegradationSource() = default;
+    /* predicted decay of a tyre of the given compound after tyreLife laps */
+    virtual SectorDecay decay(const Compound& compound, const int& tyreLife) = 0;
+};
+
+/* Asks the tyre-decay model directly, one forward pass per query */
+class ModelDegradation : public DegradationSource {
+public:
+    ModelDegradation(Model& model, CarProfile car);
+    ~ModelDegradation() override = default;
+    SectorDecay decay(const Compound& compound, const int& tyreLife) override;
+
+private:
+    Model& model;
+    CarProfile car;
+};
+
+/*
+ * Decay of every compound over the whole tyre-life range for one car, filled by a single batched forward pass
+ * (COMPOUND_COUNT x maxTyreLife samples) the first time it is read, then read in O(1). The table is rebuilt
+ * when the model has been trained since, or after setCar / invalidate (e.g. when the weights were edited by hand).
+ * */
+class DegradationTable : public DegradationSource {
+public:
+    DegradationTable(Model& model, CarProfile car, const int& maxTyreLife);
+    ~DegradationTable() override = default;
+    SectorDecay decay(const Compound& compound, const int& tyreLife) override;
+
+    void setCar(CarProfile car);
+    void invalidate() { this->valid = false; }
+    [[nodiscard]] bool isValid() const { return this->valid && this->builtRevision == this->model.getRevision(); }
+    [[nodiscard]] int getMaxTyreLife() const { return this->maxTyreLife; }
+
+private:
+    void build();
+
+    Model& model;
+    CarProfile car;
+    int maxTyreLife;
+    std::vector<SectorDecay> table;     // [compound x maxTyreLife + tyreLife - 1]
+    size_t builtRevision;
+    bool valid;
+};
+
+/*
+ * Decay table of an Ensemble, like DegradationTable, filled by one forward pass of the stacked members. decay is
+ * the members' mean and decayStdDev their spread around it, the band the decay prediction is uncertain by.
+ * */
+class EnsembleDegradation : public DegradationSource {
+public:
+    EnsembleDegradation(const Ensemble& ensemble, CarProfile car, const int& maxTyreLife);
+    ~EnsembleDegradation() override = default;
+    SectorDecay decay(const Compound& compound, const int& tyreLife) override;
+    SectorDecay decayStdDev(const Compound& compound, const int& tyreLife);
+
+    void setCar(CarProfile car);
+    [[nodiscard]] int getMaxTyreLife() const { return this->maxTyreLife; }
+
+private:
+    size_t index(const Compound& compound, const int& tyreLife);
+    void build();
+
+    const Ensemble& ensemble;
+    CarProfile car;
+    int maxTyreLife;
+    std::vector<SectorDecay> means;     // [compound x maxTyreLife + tyreLife - 1]
+    std::vector<SectorDecay> stdDevs;
+    bool valid;
+};
+
+/* Decay curves computed elsewhere, e.g. one car's share of a whole-grid batch, see GridEvaluator */
+class PrecomputedDegradation : public DegradationSource {
+public:
+    PrecomputedDegradation() = default;
+    ~PrecomputedDegradation() override = default;
+    SectorDecay decay(const Compound& compound, const int& tyreLife) override;
+
+    /* curve[a - 1] is the decay after a laps */
+    void setCurve(const Compound& compound, std::vector<SectorDecay> curve) { this->curves[static_cast<int>(compound)] = std::move(curve); }
+
+private:
+    std::array<std::vector<SectorDecay>, COMPOUND_COUNT> curves;
+};
+
+#endif //F1_STRATEGIES_DEGRADATION_H
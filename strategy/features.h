@@ -0,0 +1,58 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_FEATURES_H
+#define F1_STRATEGIES_FEATURES_H
+
+#include <array>
+#include <string>
+
+/*
+ * Layout of the tyre-decay model's inputs and outputs, i.e. the columns of x-preprocessed-data.csv and
+ * y-preprocessed-data.csv as written by collect_data.py.
+ * */
+
+/* INPUT FEATURE MACROS */
+#define FEATURE_COUNT 14
+#define FEATURE_LAP_TIME 0
+#define FEATURE_LAP_NUMBER 1
+#define FEATURE_STINT 2
+#define FEATURE_SECTOR_1_TIME 3
+#define FEATURE_SECTOR_2_TIME 4
+#define FEATURE_SECTOR_3_TIME 5
+#define FEATURE_SPEED_I1 6
+#define FEATURE_SPEED_I2 7
+#define FEATURE_SPEED_FL 8
+#define FEATURE_SPEED_ST 9
+#define FEATURE_COMPOUND 10
+#define FEATURE_TYRE_LIFE 11
+#define FEATURE_DRIVER 12
+#define FEATURE_TEAM 13
+/* OUTPUT MACROS */
+#define SECTOR_COUNT 3
+
+/* Same numbering as the compound mapping in collect_data.py */
+enum class Compound { SOFT, MEDIUM, HARD, INTERMEDIATE, WET };
+#define COMPOUND_COUNT 5
+
+/* Time lost per lap of tyre age in each sector (ms / lap), the model's outputs once unscaled */
+using SectorDecay = std::array<double, SECTOR_COUNT>;
+
+inline std::string compoundToStr(const Compound& compound) {
+    switch (compound) {
+        case Compound::SOFT:
+            return "SOFT";
+        case Compound::MEDIUM:
+            return "MEDIUM";
+        case Compound::HARD:
+            return "HARD";
+        case Compound::INTERMEDIATE:
+            return "INTERMEDIATE";
+        case Compound::WET:
+            return "WET";
+    }
+    return "UNKNOWN";
+}
+
+#endif //F1_STRATEGIES_FEATURES_H
@@ -0,0 +1,121 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "grid.h"
+
+#include <algorithm>
+#include <sstream>
+
+GridEvaluator::GridEvaluator(Model &model, FeatureRange driverRange, FeatureRange teamRange, const int &maxTyreLife) :
+        model(model), driverRange(driverRange), teamRange(teamRange), maxTyreLife(maxTyreLife), builtRevision(model.getRevision()) {
+    if (maxTyreLife <= 0)
+        throw std::invalid_argument("The tyre-life range must hold at least one lap!");
+}
+
+void GridEvaluator::updateCar(GridCar car) {
+    if (car.profile.features.size() != FEATURE_COUNT)
+        throw std::invalid_argument("A car profile must hold one value per model input!");
+    if (car.race.raceLaps > this->maxTyreLife) {
+        std::ostringstream oss;
+        oss << "A " << car.race.raceLaps << " lap race doesn't fit in the grid's tyre-life range of " << this->maxTyreLife << " laps.";
+        throw std::invalid_argument(oss.str());
+    }
+    car.profile.features[FEATURE_DRIVER] = this->driverRange.scale(car.key.driver);
+    car.profile.features[FEATURE_TEAM] = this->teamRange.scale(car.key.team);
+    const CarKey key = car.key;
+    this->cars.insert_or_assign(key, std::move(car));
+    this->degradations.erase(key);
+    this->engines.erase(key);
+}
+
+void GridEvaluator::updateLap(const CarKey &key, LapUpdate lap) {
+    const auto it = this->cars.find(key);
+    if (it == this->cars.end()) {
+        std::ostringstream oss;
+        oss << "Driver " << key.driver << " of team " << key.team << " isn't on the grid.";
+        throw std::invalid_argument(oss.str());
+    }
+    it->second.lap = std::move(lap);
+}
+
+void GridEvaluator::removeCar(const CarKey &key) {
+    this->cars.erase(key);
+    this->degradations.erase(key);
+    this->engines.erase(key);
+}
+
+std::map<CarKey, std::vector<StrategyPlan>> GridEvaluator::evaluate(const size_t &count) {
+    this->refreshDegradation();
+    std::map<CarKey, std::vector<StrategyPlan>> plans;
+    for (auto& [key, car] : this->cars) {
+        // a car without any set, or past the flag, has nothing to plan
+        if (std::none_of(car.race.availableSets.begin(), car.race.availableSets.end(), [](const int& sets) { return sets > 0; })
+                || (car.lap && car.lap->lapsCompleted >= car.race.raceLaps)) {
+            plans.emplace(key, std::vector<StrategyPlan>());
+            continue;
+        }
+        std::unique_ptr<StrategyEngine>& engine = this->engines[key];
+        if (!engine) engine = std::make_unique<StrategyEngine>(car.race, this->degradations.at(key));
+        if (!car.lap) {
+            plans.emplace(key, engine->plan(count));
+            continue;
+        }
+        plans.emplace(key, engine->replan(*car.lap, count));
+        // the engine keeps the correction, the same observation must not be applied twice
+        car.lap->observedDecay.reset();
+    }
+    return plans;
+}
+
+std::shared_ptr<DegradationSource> GridEvaluator::getDegradation(const CarKey &key) const {
+    const auto it = this->degradations.find(key);
+    if (it == this->degradations.end()) {
+        std::ostringstream oss;
+        oss << "No decay curves for driver " << key.driver << " of team " << key.team << ", was the grid evaluated?";
+        throw std::invalid_argument(oss.str());
+    }
+    return it->second;
+}
+
+void GridEvaluator::refreshDegradation() {
+    // curves of an older model are stale, and so are the DP tables built on them
+    if (this->builtRevision != this->model.getRevision()) {
+        this->degradations.clear();
+        this->engines.clear();
+        this->builtRevision = this->model.getRevision();
+    }
+
+    /* column layout: car by car (those without curves), then compound by compound (only those it has sets of), then tyre life */
+    std::vector<std::vector<double>> samples;
+    samples.reserve(this->cars.size() * COMPOUND_COUNT * this->maxTyreLife);
+    for (const auto& [key, car] : this->cars) {
+        if (this->degradations.contains(key)) continue;
+        for (int c = 0; c < COMPOUND_COUNT; c ++) {
+            if (car.race.availableSets[c] <= 0) continue;
+            for (int tyreLife = 1; tyreLife <= this->maxTyreLife; tyreLife ++) {
+                samples.push_back(car.profile.input(static_cast<Compound>(c), tyreLife));
+            }
+        }
+    }
+    // no car to refresh has any set, they all get an empty degradation
+    const Matrix predictions = samples.empty() ? Matrix() : this->model.predictBatch(Matrix::fromColumns(samples));
+
+    size_t column = 0;
+    for (const auto& [key, car] : this->cars) {
+        if (this->degradations.contains(key)) continue;
+        auto degradation = std::make_shared<PrecomputedDegradation>();
+        for (int c = 0; c < COMPOUND_COUNT; c ++) {
+            if (car.race.availableSets[c] <= 0) continue;
+            std::vector<SectorDecay> curve(this->maxTyreLife);
+            for (SectorDecay& decay : curve) {
+                for (size_t s = 0; s < SECTOR_COUNT; s ++) {
+                    decay[s] = car.profile.decayRanges[s].unscale(predictions(s, column));
+                }
+                column ++;
+            }
+            degradation->setCurve(static_cast<Compound>(c), std::move(curve));
+        }
+        this->degradations.emplace(key, std::move(degradation));
+    }
+}
@@ -0,0 +1,78 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_GRID_H
+#define F1_STRATEGIES_GRID_H
+
+#include <compare>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "./degradation.h"
+#include "./strategy.h"
+
+/* A car is identified by its Driver and Team codes, as factorised by collect_data.py */
+struct CarKey {
+    int driver;
+    int team;
+    auto operator <=> (const CarKey& other) const = default;
+};
+
+struct GridCar {
+    CarKey key;
+    CarProfile profile;         // FEATURE_DRIVER and FEATURE_TEAM are overwritten from the key
+    RaceParameters race;        // race as seen by this car: laps left, sets left, ...
+    std::optional<LapUpdate> lap;   // where the car is in the race (compound, tyre age, laps done), none before the start
+};
+
+/*
+ * Strategy of the whole grid at once. At a lap step the decay curves of all the cars that need them, on all the compounds they
+ * have sets of and over the whole tyre-life range, are stacked into one feature matrix (one sample per column)
+ * and go through the model in a single batched forward pass; each car's StrategyEngine then reads its share of
+ * the result, so refreshing all the rivals costs one network call instead of one per car, compound and lap.
+ *
+ * Every car keeps its StrategyEngine from one lap step to the next. A car that only moved on by a lap (updateLap)
+ * is replanned from its current set and tyre age with StrategyEngine::replan, its DP tables kept; only the cars
+ * that are new or whose profile or race changed (updateCar) go through the batch and get a new engine. Once the
+ * model's revision changes (it was trained, its parameters set, a scaler folded in), every car's curves and engine
+ * are rebuilt on the next evaluate.
+ * */
+class GridEvaluator {
+public:
+    GridEvaluator(Model& model, FeatureRange driverRange, FeatureRange teamRange, const int& maxTyreLife);
+    ~GridEvaluator() = default;
+
+    /* adds the car or replaces its previous state, e.g. with new features, its curves and engine are rebuilt */
+    void updateCar(GridCar car);
+    /* moves a car on in the race, its curves and engine are kept and its observed decay corrects them */
+    void updateLap(const CarKey& key, LapUpdate lap);
+    void removeCar(const CarKey& key);
+
+    /*
+     * one batched pass for the cars whose curves are out of date, then the best plans of every car from where it
+     * is in the race, at most count per car
+     * */
+    std::map<CarKey, std::vector<StrategyPlan>> evaluate(const size_t& count);
+
+    /* decay curves of the last evaluate, e.g. to simulate a rival's undercut */
+    [[nodiscard]] std::shared_ptr<DegradationSource> getDegradation(const CarKey& key) const;
+
+    [[nodiscard]] size_t size() const { return this->cars.size(); }
+
+private:
+    void refreshDegradation();
+
+    Model& model;
+    FeatureRange driverRange;
+    FeatureRange teamRange;
+    int maxTyreLife;
+    std::map<CarKey, GridCar> cars;
+    std::map<CarKey, std::shared_ptr<PrecomputedDegradation>> degradations;     // missing for the cars to refresh
+    std::map<CarKey, std::unique_ptr<StrategyEngine>> engines;
+    size_t builtRevision;                                                       // of the model the curves come from
+};
+
+#endif //F1_STRATEGIES_GRID_H
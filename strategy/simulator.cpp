@@ -0,0 +1,184 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+double FinishingDistribution::percentile(const double &p) const {
+    if (this->timesMs.empty())
+        throw std::invalid_argument("Can't take the percentile of an empty distribution!");
+    const double rank = std::ceil(std::clamp(p, 0., 100.) / 100. * static_cast<double>(this->timesMs.size()));
+    return this->timesMs[std::clamp<size_t>(static_cast<size_t>(rank), 1, this->timesMs.size()) - 1];
+}
+
+std::ostream& operator << (std::ostream& o, const FinishingDistribution& distribution) {
+    const std::ios_base::fmtflags flags = o.flags();
+    const std::streamsize precision = o.precision();
+    o << distribution.plan << "\n" << std::fixed << std::setprecision(2)
+      << "    mean " << distribution.meanMs / 1000. << " s, std dev " << distribution.stdDevMs / 1000. << " s"
+      << ", p10 / p50 / p90 " << distribution.percentile(10) / 1000. << " / " << distribution.percentile(50) / 1000.
+      << " / " << distribution.percentile(90) / 1000. << " s"
+      << ", fastest in " << distribution.winShare * 100. << " % of the scenarios";
+    o.flags(flags);
+    o.precision(precision);
+    return o;
+}
+
+RaceSimulator::RaceSimulator(const StrategyEngine &engine, SimulationParameters parameters,
+                             const std::shared_ptr<EnsembleDegradation> &spread) :
+        race(engine.getRace()), parameters(parameters) {
+    if (this->parameters.scenarioCount == 0)
+        throw std::invalid_argument("The simulation needs at least one scenario!");
+    if (spread && spread->getMaxTyreLife() < this->race.raceLaps)
+        throw std::invalid_argument("The spread source must cover the whole race!");
+    for (int c = 0; c < COMPOUND_COUNT; c ++) {
+        if (this->race.availableSets[c] <= 0) continue;
+        this->lapTimes[c].resize(this->race.raceLaps + 1, 0.);
+        for (int tyreLife = 1; tyreLife <= this->race.raceLaps; tyreLife ++) {
+            this->lapTimes[c][tyreLife] = engine.lapTime(static_cast<Compound>(c), tyreLife);
+        }
+        if (!spread) continue;
+        this->lapTimeStdDevs[c].resize(this->race.raceLaps + 1, 0.);
+        for (int tyreLife = 1; tyreLife <= this->race.raceLaps; tyreLife ++) {
+            // the sectors' errors are taken as fully correlated, their spreads add up like the decays do
+            double lapDecayStdDev = 0.;
+            for (const double& sectorStdDev : spread->decayStdDev(static_cast<Compound>(c), tyreLife)) {
+                lapDecayStdDev += sectorStdDev;
+            }
+            this->lapTimeStdDevs[c][tyreLife] = (tyreLife - 1) * lapDecayStdDev;
+        }
+    }
+}
+
+std::vector<FinishingDistribution> RaceSimulator::simulate(const std::vector<StrategyPlan> &plans) const {
+    for (const StrategyPlan& plan : plans) {
+        this->checkPlan(plan);
+    }
+    const size_t scenarios = this->parameters.scenarioCount;
+    std::vector<std::vector<double>> times(plans.size(), std::vector<double>(scenarios));
+
+    const size_t threadCount = std::clamp<size_t>(this->parameters.threadCount ? this->parameters.threadCount
+                                                                              : std::thread::hardware_concurrency(), 1, scenarios);
+    const auto runScenarios = [&](const size_t& first, const size_t& last) {
+        for (size_t s = first; s < last; s ++) {
+            const CounterRandom random(this->parameters.seed, s);
+            const std::vector<TrackStatus> trackStatus = this->sampleTrackStatus(random);
+            for (size_t p = 0; p < plans.size(); p ++) {
+                times[p][s] = this->raceTime(plans[p], trackStatus, random);
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t ++) {
+        threads.emplace_back(runScenarios, scenarios * t / threadCount, scenarios * (t + 1) / threadCount);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<size_t> wins(plans.size(), 0);
+    for (size_t s = 0; s < scenarios && !plans.empty(); s ++) {
+        size_t fastest = 0;
+        for (size_t p = 1; p < plans.size(); p ++) {
+            if (times[p][s] < times[fastest][s]) fastest = p;
+        }
+        wins[fastest] ++;
+    }
+
+    std::vector<FinishingDistribution> distributions;
+    for (size_t p = 0; p < plans.size(); p ++) {
+        FinishingDistribution distribution;
+        distribution.plan = plans[p];
+        distribution.timesMs = std::move(times[p]);
+        std::sort(distribution.timesMs.begin(), distribution.timesMs.end());
+        double sum = 0., squaredSum = 0.;
+        for (const double& time : distribution.timesMs) {
+            sum += time;
+        }
+        distribution.meanMs = sum / static_cast<double>(scenarios);
+        for (const double& time : distribution.timesMs) {
+            squaredSum += (time - distribution.meanMs) * (time - distribution.meanMs);
+        }
+        distribution.stdDevMs = std::sqrt(squaredSum / static_cast<double>(scenarios));
+        distribution.winShare = static_cast<double>(wins[p]) / static_cast<double>(scenarios);
+        distributions.push_back(std::move(distribution));
+    }
+    return distributions;
+}
+
+std::vector<TrackStatus> RaceSimulator::sampleTrackStatus(const CounterRandom &random) const {
+    std::vector<TrackStatus> trackStatus(this->race.raceLaps, TrackStatus::GREEN);
+    for (int lap = 0; lap < this->race.raceLaps; lap ++) {
+        if (trackStatus[lap] != TrackStatus::GREEN) continue;
+        const double draw = random.uniform(NEUTRALISATION, lap);
+        int length = 0;
+        TrackStatus status = TrackStatus::GREEN;
+        if (draw < this->parameters.safetyCarProbability) {
+            status = TrackStatus::SAFETY_CAR;
+            length = this->parameters.safetyCarLaps;
+        } else if (draw < this->parameters.safetyCarProbability + this->parameters.virtualSafetyCarProbability) {
+            status = TrackStatus::VIRTUAL_SAFETY_CAR;
+            length = this->parameters.virtualSafetyCarLaps;
+        }
+        for (int l = lap; l < lap + length && l < this->race.raceLaps; l ++) {
+            trackStatus[l] = status;
+        }
+    }
+    return trackStatus;
+}
+
+double RaceSimulator::raceTime(const StrategyPlan &plan, const std::vector<TrackStatus> &trackStatus, const CounterRandom &random) const {
+    double total = 0.;
+    for (size_t k = 0; k < plan.stints.size(); k ++) {
+        const Stint& stint = plan.stints[k];
+        const int compound = static_cast<int>(stint.compound);
+        const std::vector<double>& compoundLapTimes = this->lapTimes[compound];
+        const std::vector<double>& compoundStdDevs = this->lapTimeStdDevs[compound];
+        // drawn per compound, every stint on it in this scenario is off by the same number of deviations
+        const double decayError = compoundStdDevs.empty() ? 0. : random.normal(DECAY_NOISE, compound);
+        for (int lap = stint.startLap; lap <= stint.endLap; lap ++) {
+            const int tyreLife = lap - stint.startLap + 1;
+            switch (trackStatus[lap - 1]) {
+                case TrackStatus::GREEN:
+                    total += compoundLapTimes[tyreLife] + this->parameters.lapTimeStdDevMs * random.normal(LAP_NOISE, lap);
+                    if (!compoundStdDevs.empty()) total += decayError * compoundStdDevs[tyreLife];
+                    break;
+                case TrackStatus::VIRTUAL_SAFETY_CAR:
+                    total += this->race.baseLapTimeMs * this->parameters.virtualSafetyCarLapFactor;
+                    break;
+                case TrackStatus::SAFETY_CAR:
+                    total += this->race.baseLapTimeMs * this->parameters.safetyCarLapFactor;
+                    break;
+            }
+        }
+        if (k + 1 == plan.stints.size()) break;
+
+        // the stop happens at the end of the stint's last lap
+        double pitLoss = this->race.pitLossMs;
+        if (trackStatus[stint.endLap - 1] == TrackStatus::SAFETY_CAR) pitLoss *= this->parameters.safetyCarPitLossFactor;
+        else if (trackStatus[stint.endLap - 1] == TrackStatus::VIRTUAL_SAFETY_CAR) pitLoss *= this->parameters.virtualSafetyCarPitLossFactor;
+        total += pitLoss + this->parameters.pitLossStdDevMs * random.normal(PIT_NOISE, k);
+    }
+    return total;
+}
+
+void RaceSimulator::checkPlan(const StrategyPlan &plan) const {
+    // the stints must cover the race lap by lap, on compounds the race has sets of
+    int nextLap = 1;
+    bool isValid = !plan.stints.empty();
+    for (const Stint& stint : plan.stints) {
+        isValid &= stint.startLap == nextLap && stint.endLap >= stint.startLap && !this->lapTimes[static_cast<int>(stint.compound)].empty();
+        nextLap = stint.endLap + 1;
+    }
+    if (!isValid || nextLap != this->race.raceLaps + 1) {
+        std::ostringstream oss;
+        oss << "Invalid plan \"" << plan << "\" for a " << this->race.raceLaps << " lap race with the available sets.";
+        throw std::invalid_argument(oss.str());
+    }
+}
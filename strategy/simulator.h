@@ -0,0 +1,87 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_SIMULATOR_H
+#define F1_STRATEGIES_SIMULATOR_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "./counter-random.h"
+#include "./degradation.h"
+#include "./strategy.h"
+
+/* MONTE CARLO MACROS */
+#define MONTE_CARLO_SCENARIOS 20000
+#define MONTE_CARLO_SEED 2024
+
+enum class TrackStatus : uint8_t { GREEN, VIRTUAL_SAFETY_CAR, SAFETY_CAR };
+
+struct SimulationParameters {
+    size_t scenarioCount = MONTE_CARLO_SCENARIOS;
+    uint64_t seed = MONTE_CARLO_SEED;
+    size_t threadCount = 0;                         // 0 for one per hardware thread
+    double safetyCarProbability = 0.01;             // chance the safety car is deployed on a given green lap
+    double virtualSafetyCarProbability = 0.015;     // same for a virtual safety car
+    int safetyCarLaps = 4;
+    int virtualSafetyCarLaps = 2;
+    double safetyCarLapFactor = 1.4;                // neutralised lap times, relative to baseLapTimeMs
+    double virtualSafetyCarLapFactor = 1.3;
+    double safetyCarPitLossFactor = 0.45;           // share of the pit loss left when stopping while neutralised
+    double virtualSafetyCarPitLossFactor = 0.6;
+    double pitLossStdDevMs = 500.;
+    double lapTimeStdDevMs = 250.;
+};
+
+struct FinishingDistribution {
+    StrategyPlan plan;
+    std::vector<double> timesMs;                    // one finishing time per scenario, sorted
+    double meanMs;
+    double stdDevMs;
+    double winShare;                                // share of the scenarios in which the plan is the fastest
+
+    /* nearest-rank percentile, p in [0, 100] */
+    [[nodiscard]] double percentile(const double& p) const;
+    friend std::ostream& operator << (std::ostream& o, const FinishingDistribution& distribution);
+};
+
+/*
+ * Runs candidate plans through randomly sampled races: safety car and VSC periods, pit-loss variance and lap
+ * time noise on top of the model's degradation. Every scenario draws from its own CounterRandom stream and all
+ * plans are raced through the same scenarios (same neutralisations, same noise), so plans are compared on equal
+ * terms and the distributions only depend on the seed, not on the number of threads sharing the scenarios.
+ *
+ * Given a spread source, every scenario also draws one decay error per compound, in standard deviations of the
+ * ensemble's members, which moves that compound's whole lap-time curve up or down: the model's uncertainty is
+ * the same for the whole race, it isn't lap to lap noise. The lap times stay the engine's, the spread source only
+ * brings the band, so it should describe the same car (e.g. the ensemble the engine's EnsembleDegradation uses).
+ * */
+class RaceSimulator {
+public:
+    RaceSimulator(const StrategyEngine& engine, SimulationParameters parameters,
+                  const std::shared_ptr<EnsembleDegradation>& spread = nullptr);
+    ~RaceSimulator() = default;
+
+    [[nodiscard]] std::vector<FinishingDistribution> simulate(const std::vector<StrategyPlan>& plans) const;
+
+    [[nodiscard]] std::vector<TrackStatus> sampleTrackStatus(const CounterRandom& random) const;
+
+    [[nodiscard]] double raceTime(const StrategyPlan& plan, const std::vector<TrackStatus>& trackStatus, const CounterRandom& random) const;
+
+private:
+    /* draws of a scenario, see CounterRandom */
+    enum Channel : uint64_t { NEUTRALISATION, LAP_NOISE, PIT_NOISE, DECAY_NOISE };
+
+    void checkPlan(const StrategyPlan& plan) const;
+
+    RaceParameters race;
+    SimulationParameters parameters;
+    std::array<std::vector<double>, COMPOUND_COUNT> lapTimes;      // [compound][tyre life], green-flag laps
+    std::array<std::vector<double>, COMPOUND_COUNT> lapTimeStdDevs;    // same layout, empty without a spread source
+};
+
+#endif //F1_STRATEGIES_SIMULATOR_H
@@ -0,0 +1,233 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#include "strategy.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#define INFINITE_TIME std::numeric_limits<double>::infinity()
+
+std::ostream& operator << (std::ostream& o, const StrategyPlan& plan) {
+    o << plan.getStopCount() << (plan.getStopCount() == 1 ? " stop: " : " stops: ");
+    for (size_t i = 0; i < plan.stints.size(); i ++) {
+        const Stint& stint = plan.stints[i];
+        o << compoundToStr(stint.compound) << " (" << stint.startLap << "-" << stint.endLap << ")"
+          << (i + 1 != plan.stints.size() ? ", " : "");
+    }
+    o << " -> " << plan.totalTimeMs / 1000. << " s";
+    return o;
+}
+
+StrategyEngine::StrategyEngine(RaceParameters race, std::shared_ptr<DegradationSource> degradation) :
+        race(race), degradation(std::move(degradation)) {
+    if (this->race.raceLaps <= 0)
+        throw std::invalid_argument("A race needs at least one lap!");
+    if (this->race.minStops < 0 || this->race.maxStops < this->race.minStops)
+        throw std::invalid_argument("Invalid range of pit stops!");
+    this->computeLapTimes();
+    this->enumerateSequences();
+}
+
+std::vector<StrategyPlan> StrategyEngine::plan(const size_t& count) {
+    std::vector<StrategyPlan> plans;
+    for (SequenceTable& table : this->sequences) {
+        this->solve(table);
+        if (table.costToGo[0][0] != INFINITE_TIME) plans.push_back(this->extractPlan(table, 0, 0));
+    }
+    std::sort(plans.begin(), plans.end(), [](const StrategyPlan& a, const StrategyPlan& b) {
+        return a.totalTimeMs < b.totalTimeMs;
+    });
+    if (plans.size() > count) plans.resize(count);
+    return plans;
+}
+
+std::vector<StrategyPlan> StrategyEngine::replan(const LapUpdate &update, const size_t &count) {
+    const int lap = update.lapsCompleted;
+    const int laps = this->race.raceLaps;
+    const int longest = this->longestStint();
+    if (lap < 0 || lap >= laps)
+        throw std::invalid_argument("The race must still have laps to run!");
+    if (update.stintCompounds.empty() || update.tyreLife < 0)
+        throw std::invalid_argument("A car must have a set fitted!");
+    if (update.observedDecay && update.tyreLife < 1)
+        throw std::invalid_argument("Decay can only be observed on a set that has run a lap!");
+    const Compound compound = update.stintCompounds.back();
+    const int current = (int)update.stintCompounds.size() - 1;
+    if (this->cumulativeLapTimes[static_cast<int>(compound)].size() <= 1)
+        throw std::invalid_argument("The race has no " + compoundToStr(compound) + " sets!");
+
+    bool decayChanged = false;
+    if (update.observedDecay) {
+        double observed = 0.;
+        for (const double& sectorDecay : *update.observedDecay) {
+            observed += sectorDecay;
+        }
+        const int age = std::min(update.tyreLife, laps);
+        double& correction = this->decayCorrectionMs[static_cast<int>(compound)];
+        correction += STRATEGY_DECAY_SMOOTHING * (observed - this->predictedLapDecay[static_cast<int>(compound)][age] - correction);
+        this->computeCumulativeLapTimes(compound);
+        decayChanged = true;
+    }
+
+    std::vector<StrategyPlan> plans;
+    for (SequenceTable& table : this->sequences) {
+        const int stints = (int)table.compounds.size();
+        if (stints <= current || !std::equal(update.stintCompounds.begin(), update.stintCompounds.end(), table.compounds.begin())) continue;
+        if (table.costToGo.empty()) {
+            this->solve(table);
+        } else if (decayChanged) {
+            // rows after the last stint on the compound don't depend on its lap times
+            int lastUse = stints - 1;
+            while (lastUse > current && table.compounds[lastUse] != compound) lastUse --;
+            if (lastUse > current) this->solveStints(table, current + 1, lap);
+        }
+
+        /* the current set runs on from its age, then the rest of the sequence as solved */
+        StrategyPlan plan;
+        plan.totalTimeMs = INFINITE_TIME;
+        int bestLength = 0;
+        const int maxLength = std::min(laps - lap, longest - update.tyreLife);
+        for (int length = 1; length <= maxLength; length ++) {
+            double rest;
+            if (current == stints - 1) rest = lap + length == laps ? 0. : INFINITE_TIME;
+            else rest = lap + length < laps ? this->race.pitLossMs + table.costToGo[current + 1][lap + length] : INFINITE_TIME;
+            if (rest == INFINITE_TIME) continue;
+            const double time = this->stintTime(compound, update.tyreLife, length) + rest;
+            if (time < plan.totalTimeMs) {
+                plan.totalTimeMs = time;
+                bestLength = length;
+            }
+        }
+        if (plan.totalTimeMs == INFINITE_TIME) continue;
+        plan.stints.push_back({compound, lap + 1, lap + bestLength});
+        if (current + 1 < stints) {
+            const StrategyPlan rest = this->extractPlan(table, current + 1, lap + bestLength);
+            plan.stints.insert(plan.stints.end(), rest.stints.begin(), rest.stints.end());
+        }
+        plans.push_back(std::move(plan));
+    }
+    std::sort(plans.begin(), plans.end(), [](const StrategyPlan& a, const StrategyPlan& b) {
+        return a.totalTimeMs < b.totalTimeMs;
+    });
+    if (plans.size() > count) plans.resize(count);
+    return plans;
+}
+
+double StrategyEngine::lapTime(const Compound &compound, const int &tyreLife) const {
+    const std::vector<double>& predicted = this->predictedLapDecay[static_cast<int>(compound)];
+    double lapDecay = 0.;
+    if (tyreLife < (int)predicted.size()) {
+        lapDecay = predicted[tyreLife];
+    } else {
+        for (const double& sectorDecay : this->degradation->decay(compound, tyreLife)) {
+            lapDecay += sectorDecay;
+        }
+    }
+    lapDecay += this->decayCorrectionMs[static_cast<int>(compound)];
+    return this->race.baseLapTimeMs + this->race.compoundOffsetMs[static_cast<int>(compound)] + (tyreLife - 1) * lapDecay;
+}
+
+void StrategyEngine::computeLapTimes() {
+    for (int c = 0; c < COMPOUND_COUNT; c ++) {
+        if (this->race.availableSets[c] <= 0) continue;
+        std::vector<double>& predicted = this->predictedLapDecay[c];
+        predicted.assign(this->race.raceLaps + 1, 0.);
+        for (int tyreLife = 1; tyreLife <= this->race.raceLaps; tyreLife ++) {
+            for (const double& sectorDecay : this->degradation->decay(static_cast<Compound>(c), tyreLife)) {
+                predicted[tyreLife] += sectorDecay;
+            }
+        }
+        this->computeCumulativeLapTimes(static_cast<Compound>(c));
+    }
+}
+
+void StrategyEngine::computeCumulativeLapTimes(const Compound &compound) {
+    std::vector<double>& cumulative = this->cumulativeLapTimes[static_cast<int>(compound)];
+    cumulative.assign(this->race.raceLaps + 1, 0.);
+    for (int tyreLife = 1; tyreLife <= this->race.raceLaps; tyreLife ++) {
+        cumulative[tyreLife] = cumulative[tyreLife - 1] + this->lapTime(compound, tyreLife);
+    }
+}
+
+void StrategyEngine::enumerateSequences() {
+    std::vector<Compound> compounds;
+    std::array<int, COMPOUND_COUNT> setsUsed {};
+    const std::function<void()> extend = [&]() {
+        if ((int)compounds.size() >= this->race.minStops + 1) {
+            const bool twoCompounds = std::any_of(compounds.begin(), compounds.end(), [&compounds](const Compound& c) {
+                return c != compounds.front();
+            });
+            if (twoCompounds || !this->race.requireTwoCompounds) this->sequences.push_back({compounds, {}, {}});
+        }
+        if ((int)compounds.size() == this->race.maxStops + 1) return;
+        for (int c = 0; c < COMPOUND_COUNT; c ++) {
+            if (setsUsed[c] >= this->race.availableSets[c]) continue;
+            setsUsed[c] ++;
+            compounds.push_back(static_cast<Compound>(c));
+            extend();
+            compounds.pop_back();
+            setsUsed[c] --;
+        }
+    };
+    extend();
+}
+
+void StrategyEngine::solve(SequenceTable &table) const {
+    table.costToGo.assign(table.compounds.size(), std::vector<double>(this->race.raceLaps, INFINITE_TIME));
+    table.bestStintLaps.assign(table.compounds.size(), std::vector<int>(this->race.raceLaps, 0));
+    this->solveStints(table, 0, 0);
+}
+
+void StrategyEngine::solveStints(SequenceTable &table, const int &firstStint, const int &firstLap) const {
+    const int laps = this->race.raceLaps;
+    const int stints = (int)table.compounds.size();
+    const int longest = this->longestStint();
+
+    /* the last stint runs to the flag */
+    if (firstStint <= stints - 1) {
+        for (int lap = firstLap; lap < laps; lap ++) {
+            const bool fits = laps - lap <= longest;
+            table.costToGo[stints - 1][lap] = fits ? this->stintTime(table.compounds.back(), 0, laps - lap) : INFINITE_TIME;
+            table.bestStintLaps[stints - 1][lap] = fits ? laps - lap : 0;
+        }
+    }
+    for (int k = stints - 2; k >= firstStint; k --) {
+        const std::vector<double>& next = table.costToGo[k + 1];
+        for (int lap = firstLap; lap < laps; lap ++) {
+            double& best = table.costToGo[k][lap];
+            best = INFINITE_TIME;
+            for (int length = 1; length <= longest && lap + length < laps; length ++) {
+                if (next[lap + length] == INFINITE_TIME) continue;
+                const double time = this->stintTime(table.compounds[k], 0, length) + this->race.pitLossMs + next[lap + length];
+                if (time < best) {
+                    best = time;
+                    table.bestStintLaps[k][lap] = length;
+                }
+            }
+        }
+    }
+}
+
+StrategyPlan StrategyEngine::extractPlan(const SequenceTable &table, const int &firstStint, const int &firstLap) const {
+    StrategyPlan plan;
+    plan.totalTimeMs = table.costToGo[firstStint][firstLap];
+    int lap = firstLap;
+    for (size_t k = firstStint; k < table.compounds.size(); k ++) {
+        const int length = table.bestStintLaps[k][lap];
+        plan.stints.push_back({table.compounds[k], lap + 1, lap + length});
+        lap += length;
+    }
+    return plan;
+}
+
+double StrategyEngine::stintTime(const Compound &compound, const int &startTyreLife, const int &laps) const {
+    const std::vector<double>& cumulative = this->cumulativeLapTimes[static_cast<int>(compound)];
+    return cumulative[startTyreLife + laps] - cumulative[startTyreLife];
+}
+
+int StrategyEngine::longestStint() const {
+    return this->race.maxStintLaps > 0 ? std::min(this->race.maxStintLaps, this->race.raceLaps) : this->race.raceLaps;
+}
@@ -0,0 +1,112 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+#ifndef F1_STRATEGIES_STRATEGY_H
+#define F1_STRATEGIES_STRATEGY_H
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include "./degradation.h"
+#include "./features.h"
+
+/* STRATEGY MACROS */
+#define STRATEGY_MIN_STOPS 1
+#define STRATEGY_MAX_STOPS 3
+#define STRATEGY_DECAY_SMOOTHING 0.3      // weight of a new decay observation in the running correction
+
+struct RaceParameters {
+    int raceLaps;
+    double pitLossMs;                                       // time lost driving through the pit lane and stopping
+    double baseLapTimeMs;                                   // lap time on a new tyre, before the compound offset
+    std::array<double, COMPOUND_COUNT> compoundOffsetMs {}; // pace of each compound on a new tyre, relative to baseLapTimeMs
+    std::array<int, COMPOUND_COUNT> availableSets {};       // sets of each compound left for the race
+    int minStops = STRATEGY_MIN_STOPS;
+    int maxStops = STRATEGY_MAX_STOPS;
+    int maxStintLaps = 0;                                   // longest stint allowed, 0 for no limit
+    bool requireTwoCompounds = true;                        // dry races must use two different compounds
+};
+
+/* Laps are numbered from 1, both ends included */
+struct Stint {
+    Compound compound;
+    int startLap;
+    int endLap;
+};
+
+struct StrategyPlan {
+    std::vector<Stint> stints;
+    double totalTimeMs;
+
+    [[nodiscard]] size_t getStopCount() const { return this->stints.size() - 1; }
+    friend std::ostream& operator << (std::ostream& o, const StrategyPlan& plan);
+};
+
+/* What is known after a lap, see StrategyEngine::replan */
+struct LapUpdate {
+    int lapsCompleted;
+    int tyreLife;                               // laps on the set currently fitted, 0 for a new one
+    std::vector<Compound> stintCompounds;       // compound of every stint so far, the current one last
+    std::optional<SectorDecay> observedDecay;   // decay measured on the current set this lap, if any
+};
+
+/*
+ * Searches every stint plan of the race: each valid compound sequence (minStops to maxStops stops, within the
+ * available sets) and, for each, every combination of stop laps. Lap times come from the degradation source,
+ * a lap on a tyre of age a costs baseLapTimeMs + compoundOffsetMs + (a - 1) x decay(compound, a).
+ *
+ * The stop laps are found with a backward dynamic programming pass over (lap, compound, tyre age): a stint
+ * always starts on a new tyre, so the age is the number of laps since the stint started and costToGo[k][l] is
+ * the fastest way to finish the race when stint k of the sequence starts after lap l. With prefix sums of the
+ * lap times a stint costs O(1), which makes a whole search O(sequences x stops x laps x stint length).
+ * */
+class StrategyEngine {
+public:
+    StrategyEngine(RaceParameters race, std::shared_ptr<DegradationSource> degradation);
+    ~StrategyEngine() = default;
+
+    /* fastest plan of every compound sequence, best first, at most count of them */
+    std::vector<StrategyPlan> plan(const size_t& count);
+
+    /*
+     * Fastest ways to finish the race from the update on, best first: the current set runs at least one more lap,
+     * then the stints left of every sequence that starts like the race so far. The DP tables are kept between
+     * calls, so an update only costs lookups over the remaining laps, unless it brings a decay observation: the
+     * compound's lap times are then corrected and only the stints of the sequences that run it again, after the
+     * current lap, are recomputed. The returned times are the times left to the flag.
+     * */
+    std::vector<StrategyPlan> replan(const LapUpdate& update, const size_t& count = 1);
+
+    [[nodiscard]] double lapTime(const Compound& compound, const int& tyreLife) const;
+
+    [[nodiscard]] const RaceParameters& getRace() const { return this->race; }
+
+private:
+    struct SequenceTable {
+        std::vector<Compound> compounds;
+        std::vector<std::vector<double>> costToGo;          // [stint][laps completed before the stint]
+        std::vector<std::vector<int>> bestStintLaps;        // length of the stint achieving costToGo
+    };
+
+    void computeLapTimes();
+    void computeCumulativeLapTimes(const Compound& compound);
+    void enumerateSequences();
+    void solve(SequenceTable& table) const;
+    void solveStints(SequenceTable& table, const int& firstStint, const int& firstLap) const;
+    [[nodiscard]] StrategyPlan extractPlan(const SequenceTable& table, const int& firstStint, const int& firstLap) const;
+    [[nodiscard]] double stintTime(const Compound& compound, const int& startTyreLife, const int& laps) const;
+    [[nodiscard]] int longestStint() const;
+
+    RaceParameters race;
+    std::shared_ptr<DegradationSource> degradation;
+    std::array<std::vector<double>, COMPOUND_COUNT> predictedLapDecay;      // [compound][a], decay of the whole lap
+    std::array<double, COMPOUND_COUNT> decayCorrectionMs {};                // observed minus predicted lap decay
+    std::array<std::vector<double>, COMPOUND_COUNT> cumulativeLapTimes;     // [compound][a], laps of tyre life 1 to a
+    std::vector<SequenceTable> sequences;
+};
+
+#endif //F1_STRATEGIES_STRATEGY_H
@@ -0,0 +1,596 @@
+//
+// Created by Emir Tuncbilek on 10/19/26.
+//
+
+/*
+ * Checks of the guarantees the library documents, one function per area. Every failed check is printed and the
+ * process exits with 1 if any failed, so ctest (or CI) can run it as is.
+ *
+ *   F1_STRATEGIES_TEST [--filter <substring>]
+ *
+ * Models look for their GPU kernel at ../neural-network/gpu_kernel, so the test runs from a directory next to
+ * neural-network; CMake runs it from neural-network itself.
+ * */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include "./data-interpretor/live-feed.h"
+#include "./data-interpretor/scaler.h"
+#include "./neural-network/fast-math.h"
+#include "./neural-network/activation-functions.h"
+#include "./neural-network/hyperparameter-search.h"
+#include "./neural-network/quantized-model.h"
+#include "./neural-network/static-model.h"
+#include "./strategy/grid.h"
+#include "./strategy/simulator.h"
+
+/* TEST MACROS */
+#define TEST_SWEEP_POINTS 2000000       // evenly spaced inputs per swept range
+#define TEST_SAMPLES 64                 // rows of the generated training sets
+#define TEST_INPUTS 14
+#define TEST_OUTPUTS 3
+
+/* Utility functions */
+
+size_t failures = 0;
+
+void check(const bool& condition, const std::string& what) {
+    if (condition) return;
+    failures ++;
+    std::cerr << "FAILED: " << what << std::endl;
+}
+
+/* inputs evenly spread over [from, to], both included, padded with values past both ends */
+std::vector<double> sweep(const double& from, const double& to) {
+    std::vector<double> inputs(TEST_SWEEP_POINTS);
+    for (size_t i = 0; i < inputs.size(); i ++) {
+        inputs[i] = from + (to - from) * (double)i / (double)(inputs.size() - 1);
+    }
+    for (const double& outside : {2. * from - to, 2. * to - from, -1e300, 1e300}) {
+        inputs.push_back(outside);
+    }
+    return inputs;
+}
+
+/*
+ * Largest error of an approximation against its reference over the inputs, for the scalar version and for the
+ * batched one (whose AVX2 lanes handle every full group of 4 when built for AVX2). relative divides by the
+ * reference.
+ * */
+void checkBound(const std::string& name, const std::vector<double>& inputs, const double& bound, const bool& relative,
+                const std::function<double(double)>& reference, const std::function<double(double)>& scalar,
+                const std::function<void(const double*, double*, const size_t&)>& batched) {
+    std::vector<double> outputs(inputs.size());
+    if (batched) batched(inputs.data(), outputs.data(), inputs.size());
+    double scalarError = 0., batchedError = 0.;
+    for (size_t i = 0; i < inputs.size(); i ++) {
+        const double expected = reference(inputs[i]);
+        const double scale = relative ? std::abs(expected) : 1.;
+        scalarError = std::max(scalarError, std::abs(scalar(inputs[i]) - expected) / scale);
+        if (batched) batchedError = std::max(batchedError, std::abs(outputs[i] - expected) / scale);
+    }
+    check(scalarError <= bound, name + " scalar error " + std::to_string(scalarError) + " is over its bound");
+    check(batchedError <= bound, name + " batched error " + std::to_string(batchedError) + " is over its bound");
+    std::cout << "    " << name << " : scalar " << scalarError;
+    if (batched) std::cout << ", batched " << batchedError;
+    std::cout << " (bound " << bound << ")" << std::endl;
+}
+
+/* TEST_SAMPLES random samples with targets that depend on them, one per column vector */
+std::pair<std::vector<Matrix>, std::vector<Matrix>> generateDataset(const unsigned& seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(0., 1.);
+    std::vector<Matrix> X, Y;
+    for (size_t i = 0; i < TEST_SAMPLES; i ++) {
+        std::vector<double> x(TEST_INPUTS), y(TEST_OUTPUTS, 0.);
+        for (size_t k = 0; k < x.size(); k ++) {
+            x[k] = distribution(generator);
+            y[k % y.size()] += x[k] / (double)x.size();
+        }
+        X.push_back(Matrix::columnVector(x));
+        Y.push_back(Matrix::columnVector(y));
+    }
+    return {X, Y};
+}
+
+/* an activation whose forward pass always throws, standing in for a training that fails */
+class ThrowingActivation : public ActivationFunction {
+public:
+    Matrix function(const Matrix&) override { throw std::runtime_error("training failed"); }
+    double apply(const double&) const override { throw std::runtime_error("training failed"); }
+    double derivative(const double&) override { return 0.; }
+    std::unique_ptr<ActivationFunction> clone() const override { return std::make_unique<ThrowingActivation>(*this); }
+private:
+    void print(std::ostream& o) const override { o << "Throwing"; }
+};
+
+/* decay that grows with the tyre's age, faster on the softer compounds, plus the compound's offset on every lap */
+class LinearDegradation : public DegradationSource {
+public:
+    explicit LinearDegradation(const std::array<double, COMPOUND_COUNT>& offsetsMs = {}) : offsetsMs(offsetsMs) {}
+    SectorDecay decay(const Compound& compound, const int& tyreLife) override {
+        const double rate = 4. - static_cast<int>(compound);
+        return {rate * (6. + 0.3 * tyreLife) + this->offsetsMs[static_cast<int>(compound)], rate * 5., rate * (4. + 0.1 * tyreLife)};
+    }
+private:
+    std::array<double, COMPOUND_COUNT> offsetsMs;
+};
+
+/* the plans follow the same stints and their times agree to rounding */
+bool samePlan(const StrategyPlan& a, const StrategyPlan& b) {
+    if (std::abs(a.totalTimeMs - b.totalTimeMs) > 1e-6 * std::abs(b.totalTimeMs) || a.stints.size() != b.stints.size()) return false;
+    for (size_t k = 0; k < a.stints.size(); k ++) {
+        if (a.stints[k].compound != b.stints[k].compound || a.stints[k].startLap != b.stints[k].startLap
+            || a.stints[k].endLap != b.stints[k].endLap) return false;
+    }
+    return true;
+}
+
+/* Fast math, see fast-math.h: the measured bounds hold, which also keeps the documented ones */
+void testFastMath() {
+    static_assert(FAST_EXP_MEASURED_RELATIVE_ERROR <= FAST_EXP_MAX_RELATIVE_ERROR && FAST_TANH_MEASURED_ABSOLUTE_ERROR <= FAST_TANH_MAX_ABSOLUTE_ERROR
+                  && FAST_SIGMOID_MEASURED_ABSOLUTE_ERROR <= FAST_SIGMOID_MAX_ABSOLUTE_ERROR
+                  && FAST_TANH_DERIVATIVE_MEASURED_ERROR <= FAST_TANH_MAX_ABSOLUTE_ERROR, "a measured bound is over its documented one");
+    // exp's bound only holds up to the clamp, inputs past it saturate and are checked apart
+    std::vector<double> expInputs = sweep(-FAST_EXP_LIMIT, FAST_EXP_LIMIT);
+    expInputs.resize(TEST_SWEEP_POINTS);
+    checkBound("exp", expInputs, FAST_EXP_MEASURED_RELATIVE_ERROR, true,
+               [](double x) { return std::exp(x); }, [](double x) { return fastMath::exp(x); },
+               [](const double* input, double* output, const size_t& size) { fastMath::exp(input, output, size); });
+    check(std::isfinite(fastMath::exp(1e300)) && fastMath::exp(-1e300) > 0., "exp must stay finite and positive past its clamp");
+
+    checkBound("tanh", sweep(-FAST_TANH_LIMIT, FAST_TANH_LIMIT), FAST_TANH_MEASURED_ABSOLUTE_ERROR, false,
+               [](double x) { return std::tanh(x); }, [](double x) { return fastMath::tanh(x); },
+               [](const double* input, double* output, const size_t& size) { fastMath::tanh(input, output, size); });
+    checkBound("sigmoid", sweep(-FAST_EXP_LIMIT, FAST_EXP_LIMIT), FAST_SIGMOID_MEASURED_ABSOLUTE_ERROR, false,
+               [](double x) { return 1. / (1. + std::exp(-x)); }, [](double x) { return fastMath::sigmoid(x); },
+               [](const double* input, double* output, const size_t& size) { fastMath::sigmoid(input, output, size); });
+    for (const double& alpha : {1., 0.3}) {
+        std::ostringstream name;
+        name << "ELU, alpha = " << alpha;
+        checkBound(name.str(), sweep(-FAST_EXP_LIMIT, FAST_TANH_LIMIT), alpha * FAST_EXP_MEASURED_RELATIVE_ERROR, false,
+                   [alpha](double x) { return x >= 0 ? x : alpha * (std::exp(x) - 1); },
+                   [alpha](double x) { return ELU(alpha, true).apply(x); },
+                   [alpha](const double* input, double* output, const size_t& size) { fastMath::elu(input, output, size, alpha); });
+    }
+
+    // the derivative the training uses, 1 - tanh^2, has no batched version
+    TanH tanh(0.01, true);
+    checkBound("tanh derivative", sweep(-FAST_TANH_LIMIT, FAST_TANH_LIMIT), FAST_TANH_DERIVATIVE_MEASURED_ERROR, false,
+               [](double x) { return 1. - std::tanh(x) * std::tanh(x); }, [&tanh](double x) { return tanh.derivative(x); }, nullptr);
+}
+
+/* Hyperparameter search, see hyperparameter-search.h */
+void testSearch() {
+    const auto [X, Y] = generateDataset(1);
+    const auto [validationX, validationY] = generateDataset(2);
+
+    // configurations that throw, diverge to NaN (ELU with SGD at a high rate) or train fine share the search
+    SearchSpace space;
+    space.hiddenLayers = {{16}};
+    space.activations = {std::make_shared<ThrowingActivation>(), std::make_shared<ELU>(1.), std::make_shared<TanH>(0.01)};
+    space.optimizers = {OptimizerKind::SGD, OptimizerKind::RMSPROP};
+    space.batchSizes = {1, 8};
+    space.minLearningRate = 1e-3;
+    space.maxLearningRate = 5e-2;
+    SearchParameters parameters;
+    parameters.configurationCount = 9;
+    parameters.minEpochs = 2;
+    parameters.maxEpochs = 6;
+
+    HyperparameterSearch search(space, parameters);
+    std::vector<SearchResult> leaderboard;
+    try {
+        leaderboard = search.run(X, Y, validationX, validationY);
+    } catch (const std::exception& e) {
+        check(false, std::string("a failing configuration aborted the search : ") + e.what());
+        return;
+    }
+    check(leaderboard.size() == parameters.configurationCount, "every configuration must be on the leaderboard");
+    size_t failed = 0;
+    for (const SearchResult& result : leaderboard) {
+        if (dynamic_cast<ThrowingActivation*>(result.configuration.activation.get())) {
+            failed ++;
+            check(result.failure == "training failed", "a throwing configuration must record its failure");
+            check(std::isinf(result.validationLoss) && result.epochs == 0, "a throwing configuration must rank with an infinite loss");
+        } else {
+            check(result.failure.empty(), "only the throwing configurations may fail");
+        }
+    }
+    check(failed > 0, "the search space must have sampled a throwing configuration");
+    check(leaderboard.front().failure.empty() && std::isfinite(leaderboard.front().validationLoss), "a failing configuration must never lead");
+    check(search.takeBestModel() != nullptr, "the search must keep its best model");
+}
+
+/* Static model, see static-model.h */
+constexpr double TEST_LEAKY_ALPHA = 0.01;
+
+template <typename Network>
+bool loadsInto(const Model& model) {
+    try {
+        Network::fromModel(model);
+        return true;
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+}
+
+void testStaticModel() {
+    const auto modelWith = [](const ActivationFunction& activation) {
+        auto model = std::make_unique<Model>(TEST_INPUTS, activation, std::make_unique<MSE>(0.1));
+        model->addLayer(activation, TEST_OUTPUTS);
+        return model;
+    };
+    using TanHNetwork = StaticModel<StaticLayer<TEST_INPUTS, TEST_INPUTS, StaticTanH>, StaticLayer<TEST_INPUTS, TEST_OUTPUTS, StaticTanH>>;
+    using LeakyNetwork = StaticModel<StaticLayer<TEST_INPUTS, TEST_INPUTS, StaticLeakyReLU<TEST_LEAKY_ALPHA>>,
+                                     StaticLayer<TEST_INPUTS, TEST_OUTPUTS, StaticLeakyReLU<TEST_LEAKY_ALPHA>>>;
+    const auto exact = modelWith(TanH(0.01));
+    check(loadsInto<TanHNetwork>(*exact), "an exact TanH model must load into StaticTanH layers");
+    check(!loadsInto<TanHNetwork>(*modelWith(TanH(0.01, true))), "an approximate TanH model must not load into StaticTanH layers");
+    check(loadsInto<LeakyNetwork>(*modelWith(LeakyReLU(TEST_LEAKY_ALPHA))), "a LeakyReLU of the same alpha must load");
+    check(!loadsInto<LeakyNetwork>(*modelWith(LeakyReLU(0.02))), "a LeakyReLU of another alpha must not load");
+
+    // the loaded network computes what the model does, to the bit
+    const auto [X, Y] = generateDataset(3);
+    const std::unique_ptr<TanHNetwork> network = TanHNetwork::fromModel(*exact);
+    bool identical = true;
+    for (const Matrix& x : X) {
+        const Matrix expected = exact->predict(x), actual = network->predict(x);
+        for (size_t i = 0; i < TEST_OUTPUTS; i ++) identical &= expected(i, 0) == actual(i, 0);
+    }
+    check(identical, "a static model must predict exactly what its model predicts");
+}
+
+/* Quantized model, see quantized-model.h */
+void testQuantizedModel() {
+    Model model(TEST_INPUTS, TanH(0.01), std::make_unique<MSE>(0.1));
+    model.addLayer(TanH(0.01), 64);
+    model.addLayer(TanH(0.01), TEST_OUTPUTS);
+    const auto [X, Y] = generateDataset(5);
+    const QuantizedModel quantizedModel(model, X, QUANTIZATION_CALIBRATION_SAMPLES);
+
+    // a batch that is not a whole number of blocks goes through the blocked product and the one-sample tail
+    const std::vector<Matrix> samples(X.begin(), X.begin() + 7);
+    std::vector<std::vector<double>> columns;
+    for (const Matrix& x : samples) {
+        std::vector<double> column(TEST_INPUTS);
+        for (size_t k = 0; k < TEST_INPUTS; k ++) column[k] = x(k, 0);
+        columns.push_back(column);
+    }
+    const Matrix batched = quantizedModel.predictBatch(Matrix::fromColumns(columns));
+    double error = 0.;
+    for (size_t j = 0; j < samples.size(); j ++) {
+        const Matrix single = quantizedModel.predict(samples[j]);
+        for (size_t i = 0; i < TEST_OUTPUTS; i ++) error = std::max(error, std::abs(batched(i, j) - single(i, 0)));
+    }
+    check(batched.getColumnSize() == samples.size() && error < 1e-6, "a batch must predict what its samples predict one at a time");
+
+    // saved next to the float model it loads back, unless a row of weights was cut short
+    const std::string path = "test-quantized.model";
+    model.save(path);
+    quantizedModel.save(path);
+    try {
+        QuantizedModel::importModel(path);
+    } catch (const std::exception& e) {
+        check(false, std::string("a saved quantized model must load back : ") + e.what());
+    }
+    std::stringstream contents;
+    contents << std::ifstream("../quantized_" + path).rdbuf();
+    std::string text = contents.str();
+    const size_t rowEnd = text.find("],", text.find("],") + 2);  // the second row, the first sets the width
+    text.erase(text.rfind(", ", rowEnd), rowEnd - text.rfind(", ", rowEnd));
+    std::ofstream("../quantized_" + path) << text;
+    bool refused = false;
+    try {
+        QuantizedModel::importModel(path);
+    } catch (const std::invalid_argument&) {
+        refused = true;
+    }
+    check(refused, "a quantized model with a short row of weights must not load");
+    for (const std::string prefix : {"weights_", "biases_", "activations_", "quantized_"}) {
+        std::remove(("../" + prefix + path).c_str());
+    }
+}
+
+/* Grid, see strategy/grid.h */
+void testGrid() {
+    Model model(FEATURE_COUNT, TanH(0.01), std::make_unique<MSE>(0.1));
+    model.addLayer(TanH(0.01), SECTOR_COUNT);
+    GridEvaluator grid(model, {0., 20.}, {0., 10.}, 60);
+    GridCar car;
+    car.key = {1, 1};
+    car.profile.features = std::vector<double>(FEATURE_COUNT, 0.5);
+    car.race.raceLaps = 50;
+    grid.updateCar(car);
+
+    // no car has a set, so nothing goes through the model
+    std::map<CarKey, std::vector<StrategyPlan>> plans;
+    try {
+        plans = grid.evaluate(3);
+    } catch (const std::exception& e) {
+        check(false, std::string("a grid without sets must not throw : ") + e.what());
+        return;
+    }
+    check(plans.size() == 1 && plans.at(car.key).empty(), "a car without sets must get no plans");
+
+    // mid-race, a car is planned from its current set and age, as its own engine would replan it
+    car.race.availableSets = {2, 2, 2, 0, 0};
+    car.race.compoundOffsetMs = {0., 400., 800., 0., 0.};
+    car.race.baseLapTimeMs = 90000.;
+    car.race.pitLossMs = 20000.;
+    for (FeatureRange& range : car.profile.decayRanges) range = {0., 200.};
+    grid.updateCar(car);
+    for (const int& lap : {10, 11}) {
+        const LapUpdate update {lap, lap, {Compound::MEDIUM}, std::nullopt};
+        grid.updateLap(car.key, update);
+        const std::vector<StrategyPlan> gridPlans = grid.evaluate(3).at(car.key);
+        StrategyEngine engine(car.race, grid.getDegradation(car.key));
+        const std::vector<StrategyPlan> expected = engine.replan(update, 3);
+        bool same = !gridPlans.empty() && gridPlans.size() == expected.size();
+        for (size_t p = 0; same && p < gridPlans.size(); p ++) {
+            same = gridPlans[p].totalTimeMs == expected[p].totalTimeMs && gridPlans[p].stints.size() == expected[p].stints.size()
+                   && gridPlans[p].stints.front().startLap == lap + 1 && gridPlans[p].stints.front().compound == Compound::MEDIUM;
+        }
+        check(same, "a car must be replanned from lap " + std::to_string(lap) + " on its current set");
+    }
+
+    // new weights make every curve stale
+    const std::shared_ptr<DegradationSource> before = grid.getDegradation(car.key);
+    Model retrained(FEATURE_COUNT, TanH(0.01), std::make_unique<MSE>(0.1));
+    retrained.addLayer(TanH(0.01), SECTOR_COUNT);
+    model.setParameters(retrained.getParameters());
+    grid.evaluate(3);
+    const std::shared_ptr<DegradationSource> after = grid.getDegradation(car.key);
+    check(after != before && after->decay(Compound::MEDIUM, 5) != before->decay(Compound::MEDIUM, 5),
+          "the grid must rebuild its curves once the model changed");
+}
+
+/* Strategy engine, see strategy/strategy.h */
+void testStrategy() {
+    RaceParameters race;
+    race.raceLaps = 40;
+    race.pitLossMs = 20000.;
+    race.baseLapTimeMs = 90000.;
+    race.compoundOffsetMs = {0., 400., 800., 0., 0.};
+    race.availableSets = {2, 2, 2, 0, 0};
+    StrategyEngine engine(race, std::make_shared<LinearDegradation>());
+    const std::vector<StrategyPlan> plans = engine.plan(1000);
+
+    // on a short race, every stop lap of every sequence can be tried: the search must find the best of each
+    RaceParameters shortRace = race;
+    shortRace.raceLaps = 12;
+    shortRace.maxStintLaps = 7;
+    StrategyEngine shortEngine(shortRace, std::make_shared<LinearDegradation>());
+    const auto stintsTime = [&shortEngine, &shortRace](const std::vector<Stint>& stints) {
+        double time = shortRace.pitLossMs * (double)(stints.size() - 1);
+        for (const Stint& stint : stints) {
+            for (int tyreLife = 1; tyreLife <= stint.endLap - stint.startLap + 1; tyreLife ++) time += shortEngine.lapTime(stint.compound, tyreLife);
+        }
+        return time;
+    };
+    std::map<std::vector<Compound>, double> bruteForce;
+    std::vector<Compound> compounds;
+    std::vector<Stint> stints;
+    const std::function<void(int)> tryStints = [&](const int& lap) {
+        const int stint = (int)stints.size();
+        if (stint == (int)compounds.size()) {
+            if (lap != shortRace.raceLaps) return;
+            const double time = stintsTime(stints);
+            const auto best = bruteForce.find(compounds);
+            if (best == bruteForce.end() || time < best->second) bruteForce[compounds] = time;
+            return;
+        }
+        for (int length = 1; length <= shortRace.maxStintLaps && lap + length <= shortRace.raceLaps; length ++) {
+            stints.push_back({compounds[stint], lap + 1, lap + length});
+            tryStints(lap + length);
+            stints.pop_back();
+        }
+    };
+    const std::function<void()> trySequences = [&]() {
+        const std::set<Compound> used(compounds.begin(), compounds.end());
+        if ((int)compounds.size() > shortRace.minStops && used.size() > 1) tryStints(0);
+        if ((int)compounds.size() > shortRace.maxStops) return;
+        for (const Compound& compound : {Compound::SOFT, Compound::MEDIUM, Compound::HARD}) {
+            if (std::count(compounds.begin(), compounds.end(), compound) >= shortRace.availableSets[static_cast<int>(compound)]) continue;
+            compounds.push_back(compound);
+            trySequences();
+            compounds.pop_back();
+        }
+    };
+    trySequences();
+    const std::vector<StrategyPlan> shortPlans = shortEngine.plan(1000);
+    bool optimal = !shortPlans.empty() && shortPlans.size() == bruteForce.size();
+    for (const StrategyPlan& plan : shortPlans) {
+        std::vector<Compound> sequence;
+        for (const Stint& stint : plan.stints) sequence.push_back(stint.compound);
+        const auto best = bruteForce.find(sequence);
+        optimal = optimal && best != bruteForce.end() && std::abs(plan.totalTimeMs - best->second) < 1e-6
+                  && std::abs(stintsTime(plan.stints) - plan.totalTimeMs) < 1e-6;
+    }
+    check(optimal, "the search must find the fastest stop laps of every sequence an enumeration finds");
+
+    // on the grid, before any observation, a replan is the plan of the sequences starting on the fitted compound
+    for (const Compound& compound : {Compound::SOFT, Compound::MEDIUM, Compound::HARD}) {
+        StrategyEngine fresh(race, std::make_shared<LinearDegradation>());
+        const std::vector<StrategyPlan> replans = fresh.replan({0, 0, {compound}, std::nullopt}, 1000);
+        size_t starting = 0;
+        bool same = !replans.empty();
+        for (const StrategyPlan& plan : plans) {
+            if (plan.stints.front().compound != compound) continue;
+            starting ++;
+            same = same && std::any_of(replans.begin(), replans.end(), [&plan](const StrategyPlan& replan) { return samePlan(replan, plan); });
+        }
+        check(same && starting == replans.size(), "a replan at lap 0 must match the plan on " + compoundToStr(compound));
+    }
+
+    // an observation corrects the compound's decay on every age, as a source predicting the corrected decay would
+    const LapUpdate before {9, 9, {Compound::SOFT}, std::nullopt};
+    engine.replan(before, 1000);
+    const SectorDecay observed {30., 25., 12.};
+    const LapUpdate after {10, 10, {Compound::SOFT}, observed};
+    const std::vector<StrategyPlan> corrected = engine.replan(after, 1000);
+    double predicted = 0.;
+    for (const double& sectorDecay : LinearDegradation().decay(Compound::SOFT, 10)) predicted += sectorDecay;
+    std::array<double, COMPOUND_COUNT> correction {};
+    correction[static_cast<int>(Compound::SOFT)] = STRATEGY_DECAY_SMOOTHING * (observed[0] + observed[1] + observed[2] - predicted);
+    const std::vector<StrategyPlan> expected = StrategyEngine(race, std::make_shared<LinearDegradation>(correction))
+            .replan({after.lapsCompleted, after.tyreLife, after.stintCompounds, std::nullopt}, 1000);
+    bool same = !corrected.empty() && corrected.size() == expected.size();
+    for (size_t p = 0; same && p < corrected.size(); p ++) same = samePlan(corrected[p], expected[p]);
+    check(same, "a replan after an observation must match a full solve on the corrected decay");
+}
+
+/* Live feed, see data-interpretor/live-feed.h */
+void testLiveFeed() {
+    Model model(FEATURE_COUNT, TanH(0.01), std::make_unique<MSE>(0.1));
+    model.addLayer(TanH(0.01), SECTOR_COUNT);
+    const Scaler inputScaler(std::vector<double>(FEATURE_COUNT, 0.), std::vector<double>(FEATURE_COUNT, 1.));
+    const Scaler outputScaler(std::vector<double>(SECTOR_COUNT, 0.), std::vector<double>(SECTOR_COUNT, 1.));
+    std::vector<SectorDecay> observed;
+    LiveFeed feed(model, inputScaler, outputScaler, [&observed](const TimingRecord& lap, const SectorDecay&) {
+        observed.push_back(*lap.decayRatesMs);
+    });
+    int sockets[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) < 0) {
+        check(false, "a socket pair must be available");
+        return;
+    }
+    feed.start(sockets[0]);
+    // the second session's lap is slower than the first session's best, but it is the best of its own session
+    const std::string lines = "FP1,80000,1,1,25000,30000,25000,280,290,270,310,SOFT,1,VER,Red Bull\n"
+                              "FP1,81000,2,1,25500,30300,25200,280,290,270,310,SOFT,2,VER,Red Bull\n"
+                              "FP2,82000,3,1,26000,30500,25500,280,290,270,310,SOFT,1,VER,Red Bull\n";
+    const bool written = ::write(sockets[1], lines.data(), lines.size()) == (ssize_t)lines.size();
+    ::close(sockets[1]);
+    feed.wait();
+    check(written && observed.size() == 3, "every lap written must go through the feed");
+    check(observed.size() == 3 && observed[1][0] == 500. && observed[2] == SectorDecay {0., 0., 0.},
+          "the decay rates must be measured against the personal bests of the lap's own session");
+}
+
+/* Scaler, see data-interpretor/scaler.h */
+void testScaler() {
+    std::vector<double> dataMin(TEST_INPUTS), dataMax(TEST_INPUTS);
+    for (size_t k = 0; k < TEST_INPUTS; k ++) {
+        dataMin[k] = -(double)k;
+        dataMax[k] = 2. * (double)k;
+    }
+    const Scaler scaler(dataMin, dataMax);
+    Model model(TEST_INPUTS, TanH(0.01), std::make_unique<MSE>(0.1));
+    model.addLayer(TanH(0.01), TEST_OUTPUTS);
+
+    // the folded model takes raw features and predicts what the scaled ones gave
+    const auto [X, Y] = generateDataset(4);
+    std::vector<Matrix> expected;
+    for (const Matrix& x : X) {
+        std::vector<double> scaled(TEST_INPUTS);
+        for (size_t k = 0; k < TEST_INPUTS; k ++) scaled[k] = x(k, 0);
+        scaler.transform(scaled.data(), scaled.data());
+        expected.push_back(model.predict(Matrix::columnVector(scaled)));
+    }
+    const size_t revision = model.getRevision();
+    scaler.foldInto(model);
+    check(model.getRevision() != revision, "folding a scaler must make caches of the model's predictions stale");
+    double error = 0.;
+    for (size_t j = 0; j < X.size(); j ++) {
+        const Matrix actual = model.predict(X[j]);
+        for (size_t i = 0; i < TEST_OUTPUTS; i ++) error = std::max(error, std::abs(actual(i, 0) - expected[j](i, 0)));
+    }
+    check(error < 1e-12, "a folded model must predict on raw features what it predicted on scaled ones");
+}
+
+/* Race simulator, see strategy/simulator.h */
+void testSimulator() {
+    const auto member = []() {
+        auto model = std::make_unique<Model>(FEATURE_COUNT, TanH(0.01), std::make_unique<MSE>(0.1));
+        model->addLayer(TanH(0.01), SECTOR_COUNT);
+        return model;
+    };
+    std::vector<std::unique_ptr<Model>> agreeing, disagreeing;
+    agreeing.push_back(member());
+    agreeing.push_back(member());
+    const size_t revision = agreeing[1]->getRevision();
+    agreeing[1]->setParameters(agreeing[0]->getParameters());
+    check(agreeing[1]->getRevision() != revision, "setting the parameters must make caches of the model's predictions stale");
+    disagreeing.push_back(member());
+    disagreeing.push_back(member());
+    const Ensemble agreeingEnsemble(agreeing), disagreeingEnsemble(disagreeing);
+
+    RaceParameters race;
+    race.raceLaps = 30;
+    race.pitLossMs = 20000.;
+    race.baseLapTimeMs = 90000.;
+    race.compoundOffsetMs = {0., 400., 800., 0., 0.};
+    race.availableSets = {2, 2, 2, 0, 0};
+    CarProfile car;
+    car.features = std::vector<double>(FEATURE_COUNT, 0.5);
+    for (FeatureRange& range : car.decayRanges) range = {0., 200.};
+    SimulationParameters parameters;
+    parameters.scenarioCount = 2000;
+
+    const auto simulate = [&](const Ensemble& ensemble, const bool& withSpread) {
+        const auto degradation = std::make_shared<EnsembleDegradation>(ensemble, car, race.raceLaps);
+        StrategyEngine engine(race, degradation);
+        const std::vector<StrategyPlan> plans = engine.plan(2);
+        return RaceSimulator(engine, parameters, withSpread ? degradation : nullptr).simulate(plans);
+    };
+    const auto sameTimes = [](const std::vector<FinishingDistribution>& a, const std::vector<FinishingDistribution>& b) {
+        bool same = a.size() == b.size();
+        for (size_t p = 0; same && p < a.size(); p ++) same = a[p].timesMs == b[p].timesMs;
+        return same;
+    };
+    check(sameTimes(simulate(agreeingEnsemble, false), simulate(agreeingEnsemble, true)),
+          "members that agree must leave the simulated races as they are");
+    const std::vector<FinishingDistribution> banded = simulate(disagreeingEnsemble, true);
+    check(!sameTimes(simulate(disagreeingEnsemble, false), banded), "the ensemble's spread must reach the simulated races");
+    check(sameTimes(banded, simulate(disagreeingEnsemble, true)), "the decay noise must only depend on the seed");
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    for (int i = 1; i < argc; i ++) {
+        const std::string argument = argv[i];
+        if (argument == "--filter" && i + 1 < argc) filter = argv[++ i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter <substring>]" << std::endl;
+            return 1;
+        }
+    }
+
+    const std::vector<std::pair<std::string, std::function<void()>>> tests = {
+            {"fast math", testFastMath},
+            {"hyperparameter search", testSearch},
+            {"static model", testStaticModel},
+            {"quantized model", testQuantizedModel},
+            {"grid", testGrid},
+            {"strategy", testStrategy},
+            {"live feed", testLiveFeed},
+            {"scaler", testScaler},
+            {"simulator", testSimulator},
+    };
+    for (const auto& [name, test] : tests) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+        std::cout << name << std::endl;
+        test();
+    }
+#if defined(__AVX2__)
+    std::cout << "Batched functions checked on their AVX2 path" << std::endl;
+#else
+    std::cout << "Batched functions checked on their scalar path, build with F1_NATIVE on an AVX2 machine to check the vector one" << std::endl;
+#endif
+    std::cout << (failures ? std::to_string(failures) + " check(s) failed" : "All checks passed") << std::endl;
+    return failures ? 1 : 0;
+}